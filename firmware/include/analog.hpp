@@ -0,0 +1,153 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/analog.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the sampling of a digital input on the ADC (A0) on a low rate. A
+ *               conversion of the ADC of the ESP8266 is slow and disturbs the Wi-Fi when it is done
+ *               too often. The input is converted once per ANALOG_INTERVAL, the average of the last
+ *               conversions is compared with two thresholds, so noise around one threshold does not
+ *               toggle the level. The level is cached, reading it does not convert.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): The interval can be changed, to measure the Wi-Fi throughput per interval.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#define ANALOG_INTERVAL 100 // Default time in ms between two conversions
+#define ANALOG_AVERAGE  4 // Conversions in the average, a power of 2
+#define ANALOG_HIGH     600 // The level gets high when the average is above this value
+#define ANALOG_LOW      400 // The level gets low when the average is below this value
+
+/* Class: AnalogInput
+ * The analog input class converts the ADC on a low rate and caches the level.
+ */
+class AnalogInput {
+private:
+   uint8_t pin;
+   uint16_t values[ANALOG_AVERAGE]; // Last conversions
+   uint16_t sum; // Sum of the last conversions
+   uint8_t index; // Next conversion to replace
+   bool high; // Cached level
+   uint16_t interval; // Time in ms between two conversions
+   uint64_t deadline; // Time in ms of the next conversion
+   uint32_t reads; // Total conversions
+   uint32_t cycles; // CPU cycles of the conversions
+
+   /* Convert the ADC and add the value to the average.
+    *
+    * @param None
+    * @return None
+    */
+   void convert() {
+      uint32_t begin = ESP.getCycleCount();
+      uint16_t value = analogRead(this->pin);
+      this->cycles += ESP.getCycleCount() - begin;
+      this->reads++;
+
+      this->sum = this->sum - this->values[this->index] + value;
+      this->values[this->index] = value;
+      this->index = (this->index + 1) & (ANALOG_AVERAGE - 1);
+   }
+
+public:
+   AnalogInput(uint8_t pin = A0): pin(pin), values{ 0 }, sum(0), index(0), high(false), interval(ANALOG_INTERVAL),
+                                  deadline(0), reads(0), cycles(0) {
+
+   }
+
+   /* Fill the average with one conversion, so the level is known at once.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void begin(uint64_t millis) {
+      uint16_t value = analogRead(this->pin);
+      this->reads++;
+      for ( uint8_t i=0; i < ANALOG_AVERAGE; i++ ) {
+         this->values[i] = value;
+      }
+      this->sum = value * ANALOG_AVERAGE;
+      this->index = 0;
+      this->high = (value > (ANALOG_HIGH + ANALOG_LOW) / 2);
+      this->deadline = millis + this->interval;
+   }
+
+   /* The loop method converts the ADC once per interval and updates the level with the hysteresis.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void loop(uint64_t millis) {
+      if ( millis < this->deadline ) {
+         return;
+      }
+      this->deadline = millis + this->interval;
+      this->convert();
+
+      uint16_t average = this->sum / ANALOG_AVERAGE;
+      if ( this->high && average < ANALOG_LOW ) {
+         this->high = false;
+      } else if ( !this->high && average > ANALOG_HIGH ) {
+         this->high = true;
+      }
+   }
+
+   /* Set the time between two conversions, it is used from the next conversion.
+    *
+    * @param interval: time in ms, at least 1
+    * @return None
+    */
+   void setInterval(uint16_t interval) {
+      this->interval = (interval > 0 ? interval : 1);
+   }
+
+   /* Return the time between two conversions.
+    *
+    * @param None
+    * @return Time in ms.
+    */
+   uint16_t getInterval() {
+      return this->interval;
+   }
+
+   /* Return the cached level of the input.
+    *
+    * @param None
+    * @return True when it is high.
+    */
+   bool isHigh() {
+      return this->high;
+   }
+
+   /* Return the total conversions of the ADC.
+    *
+    * @param None
+    * @return Total conversions.
+    */
+   uint32_t getReads() {
+      return this->reads;
+   }
+
+   /* Return the CPU cycles of the conversions of the ADC.
+    *
+    * @param None
+    * @return Total cycles.
+    */
+   uint32_t getCycles() {
+      return this->cycles;
+   }
+};
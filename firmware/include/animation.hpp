@@ -0,0 +1,194 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/animation.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the keyframe animations of the 7-segments display. An
+ *               animation is a sequence of keyframes in flash. The player is called from the
+ *               loop and only reads the next keyframe when its deadline has passed, so it does
+ *               not block and costs almost nothing between two keyframes.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#include <font.hpp>
+
+// Keyframe flags.
+#define KEYFRAME_COLON 0x01 // Show the colon
+#define KEYFRAME_MASK  0x02 // The digits are a visible mask over the frame, non-zero is visible
+
+// Result of the animation loop.
+enum AnimationStatus {
+   ANIMATION_IDLE,  // Nothing to do
+   ANIMATION_FRAME, // A new keyframe should be shown
+   ANIMATION_END,   // The animation is finished
+};
+
+/* Struct: Keyframe
+ * One frame of an animation that is shown for the given duration.
+ */
+struct Keyframe {
+   FontText text; // Segments of the four digits, or the visible mask with KEYFRAME_MASK
+   uint8_t flags; // KEYFRAME_ flags
+   uint16_t duration; // Time in ms that the frame is shown
+};
+
+/* Struct: Animation
+ * A sequence of keyframes in flash.
+ */
+struct Animation {
+   const Keyframe* frames; // Keyframes in flash
+   uint8_t count; // Total keyframes
+   uint8_t repeat; // Total times the sequence is played, 0 is forever
+};
+
+// Visible masks for the flash animation.
+constexpr FontText MASK_ON  = { { 0xFF, 0xFF, 0xFF, 0xFF } };
+constexpr FontText MASK_OFF = { { 0x00, 0x00, 0x00, 0x00 } };
+
+// Spinner, one segment walks around the outside of the display.
+const Keyframe SPINNER_FRAMES[] PROGMEM = {
+   { { { FONT_A, 0, 0, 0 } }, 0, 60 }, { { { 0, FONT_A, 0, 0 } }, 0, 60 },
+   { { { 0, 0, FONT_A, 0 } }, 0, 60 }, { { { 0, 0, 0, FONT_A } }, 0, 60 },
+   { { { 0, 0, 0, FONT_B } }, 0, 60 }, { { { 0, 0, 0, FONT_C } }, 0, 60 },
+   { { { 0, 0, 0, FONT_D } }, 0, 60 }, { { { 0, 0, FONT_D, 0 } }, 0, 60 },
+   { { { 0, FONT_D, 0, 0 } }, 0, 60 }, { { { FONT_D, 0, 0, 0 } }, 0, 60 },
+   { { { FONT_E, 0, 0, 0 } }, 0, 60 }, { { { FONT_F, 0, 0, 0 } }, 0, 60 },
+};
+const Animation ANIMATION_SPINNER = { SPINNER_FRAMES, 12, 0 };
+
+// Flash of the countdown in the last minute, the time is shortly hidden every second.
+const Keyframe FLASH_FRAMES[] PROGMEM = {
+   { MASK_ON,  KEYFRAME_MASK | KEYFRAME_COLON, 800 },
+   { MASK_OFF, KEYFRAME_MASK, 200 },
+};
+const Animation ANIMATION_FLASH = { FLASH_FRAMES, 2, 0 };
+
+// Fanfare when the bomb is defused, it ends with YEAH.
+const Keyframe WIN_FRAMES[] PROGMEM = {
+   { fontText("----"), 0, 150 },
+   { fontText("===="), 0, 150 },
+   { fontText("8888"), 0, 150 },
+   { fontText("YEAH"), 0, 400 },
+   { fontText("    "), 0, 100 },
+   { fontText("YEAH"), 0, 400 },
+   { fontText("    "), 0, 100 },
+   { fontText("YEAH"), 0, 0 },
+};
+const Animation ANIMATION_WIN = { WIN_FRAMES, 8, 1 };
+
+// Fanfare when the bomb explodes, it ends with LOSE.
+const Keyframe LOSE_FRAMES[] PROGMEM = {
+   { fontText("8888"), KEYFRAME_COLON, 100 },
+   { fontText("    "), 0, 100 },
+   { fontText("8888"), KEYFRAME_COLON, 100 },
+   { fontText("    "), 0, 100 },
+   { fontText("8888"), KEYFRAME_COLON, 100 },
+   { fontText("    "), 0, 300 },
+   { fontText("LOSE"), 0, 0 },
+};
+const Animation ANIMATION_LOSE = { LOSE_FRAMES, 7, 1 };
+
+/* Class: Animator
+ * The animator class plays an animation with a deadline per keyframe.
+ */
+class Animator {
+private:
+   const Animation* animation; // Animation that is playing, NULL when nothing is playing
+   uint8_t index; // Keyframe that is shown
+   uint8_t played; // Total times the sequence has been played
+   uint64_t deadline; // Time in ms when the next keyframe should be shown
+   bool started; // The first keyframe has been shown
+
+public:
+   Animator(): animation(NULL), index(0), played(0), deadline(0), started(false) {
+
+   }
+
+   /* Start to play an animation from the first keyframe.
+    *
+    * @param animation: the animation to play
+    * @param millis: current time in ms
+    * @return None
+    */
+   void play(const Animation* animation, uint64_t millis) {
+      this->animation = animation;
+      this->index = 0;
+      this->played = 0;
+      this->deadline = millis;
+      this->started = false;
+   }
+
+   /* Stop the animation.
+    *
+    * @param None
+    * @return None
+    */
+   void stop() {
+      this->animation = NULL;
+   }
+
+   /* Return whether the given animation is playing.
+    *
+    * @param animation: the animation, or NULL for any animation
+    * @return True when it is playing.
+    */
+   bool isPlaying(const Animation* animation = NULL) {
+      return this->animation != NULL && (animation == NULL || this->animation == animation);
+   }
+
+   /* The loop method checks the deadline of the next keyframe. The deadlines are calculated from the
+    * previous deadline, so the animation does not drift. When the loop was late, the missed keyframes
+    * are skipped. A keyframe with duration zero is the last one and is shown until stop or play.
+    *
+    * @param millis: current time in ms
+    * @param frame: the keyframe that should be shown when ANIMATION_FRAME is returned
+    * @return The status of the animation.
+    */
+   AnimationStatus loop(uint64_t millis, Keyframe* frame) {
+      if ( this->animation == NULL || millis < this->deadline ) {
+         return ANIMATION_IDLE;
+      }
+
+      Keyframe k;
+      do {
+         if ( this->started ) {
+            this->index++;
+            if ( this->index >= this->animation->count ) {
+               this->index = 0;
+               this->played++;
+               if ( this->animation->repeat != 0 && this->played >= this->animation->repeat ) {
+                  this->animation = NULL;
+                  return ANIMATION_END;
+               }
+            }
+         }
+         this->started = true;
+
+         memcpy_P(&k, &this->animation->frames[this->index], sizeof(Keyframe));
+         if ( k.duration == 0 ) { // Last keyframe stays
+            *frame = k;
+            this->animation = NULL;
+            return ANIMATION_FRAME;
+         }
+         this->deadline += k.duration;
+      } while ( millis >= this->deadline );
+
+      *frame = k;
+      return ANIMATION_FRAME;
+   }
+};
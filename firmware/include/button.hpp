@@ -20,29 +20,88 @@
  * @updates    : 20-02-2024 (MS): Initial code.
  *               16-06-2024 (MS): Created the first release version.
  *               27-03-2026 (MS): Fixed button long press bug!
+ *               19-10-2026 (MS): Debounce on the time of the edges instead of the loop passes.
+ *               19-10-2026 (MS): Gestures: multiple clicks, long press and hold to repeat.
  * @todo       : 
  */
 #include <driver.h>
 #include <Arduino.h>
 
-// update with counter, so anti-dender is created.
+#include <gesture.hpp>
+
+#define BUTTON_PIN       D3
+#define BUTTON_SETTLE    30 // Time in ms without an edge before the level of the button is accepted
+#define BUTTON_LONGPRESS 2000 // Time in ms that the button is held for a long press
+#define BUTTON_EDGES     32 // Edges that the interrupt can store between two loops, a power of 2
+
+// The interrupt of the button stores the time of every edge, so the debounce does not depend on how fast the
+// loop is called. A level is stable when there was no edge during the settle time after it.
 
 /* Class: Button
  * The button class provides high level function to control the button.
  */
 class Button: public IDriver {
 private:
-   uint64_t timer;
-   uint8_t value;           ///< Accumulator voor softwarematige ontstoring (debounce).
+   inline static volatile uint32_t ring[BUTTON_EDGES];    ///< Flanken die de loop nog moet verwerken: tijd in ms << 1 | ingedrukt.
+   inline static volatile uint8_t head = 0;               ///< Volgende plek in de ring, gezet door de interrupt.
+   inline static volatile uint8_t tail = 0;               ///< Volgende flank in de ring die de loop verwerkt.
+   inline static volatile uint32_t edges = 0;             ///< Totaal aantal flanken, inclusief dender.
+   inline static volatile uint32_t overflows = 0;         ///< Flanken die niet meer in de ring pasten.
+
+   uint32_t overflowsRead;  ///< Aantal overflows dat de loop al heeft gezien.
+   bool level;              ///< Stand van de knop na de laatste flank, nog niet debounced.
+   uint64_t since;          ///< Tijd in ms van de laatste flank.
+
+   uint64_t timer;          ///< Tijd in ms waarop de knop stabiel ingedrukt werd (de flank van het indrukken).
+   uint16_t settle;         ///< Tijd in ms zonder flank voordat de stand van de knop geldt.
+   uint64_t changed;        ///< Tijd in ms waarop de laatste stabiele stand begon.
 
    bool pressed;            ///< Is de knop momenteel debounced ingedrukt?
    bool longPressed;        ///< Signaal dat een long press is gedetecteerd.
    bool longPressedRead;    ///< Voorkomt dat een long press meerdere keren afgaat tijdens één keer inhouden.
    bool shortPressPending;  ///< Signaal dat er een korte klik is geweest (geactiveerd bij loslaten).
 
+   Gesture gesture;         ///< Herkent de gebaren uit het indrukken en loslaten.
+
+   /* Accept a stable level of the button. A press and a release are handled on the time of their edge, so also
+    * a click that started and ended between two loops is seen.
+    *
+    * @param level: true when pressed
+    * @param at: time in ms of the edge that started the level
+    * @return None
+    */
+   void accept(bool level, uint64_t at) {
+      if ( level == this->pressed ) {
+         return;
+      }
+      this->pressed = level;
+      this->changed = at;
+
+      if ( level ) {
+         // Knop wordt ingedrukt (Down-event)
+         this->gesture.press(at);
+         this->timer = at;
+         this->longPressed = false;
+         this->longPressedRead = false;
+         return;
+      }
+
+      this->gesture.release(at);
+      if ( !this->longPressedRead ) {
+         // Knop wordt losgelaten (Up-event), de long press kan tussen twee loops zijn begonnen en geëindigd
+         if ( at - this->timer >= BUTTON_LONGPRESS ) {
+            this->longPressed = true;
+            this->longPressedRead = true;
+         } else {
+            this->shortPressPending = true;
+         }
+      }
+   }
+
 public:
-    Button(): timer(0), value(0), pressed(false), longPressed(false), 
-              longPressedRead(false), shortPressPending(false) {
+    Button(uint16_t settle = BUTTON_SETTLE): overflowsRead(0), level(false), since(0), timer(0),
+              settle(settle), changed(0), pressed(false), longPressed(false), longPressedRead(false),
+              shortPressPending(false) {
 
     }
 
@@ -58,59 +117,79 @@ public:
     * @return Zero is successfull and non-zero when an error occurred.
     */
    uint8_t setup() {
-      pinMode(D3, INPUT_PULLUP);      
+      pinMode(BUTTON_PIN, INPUT_PULLUP);
+      Button::head = 0;
+      Button::edges = 0;
+      Button::overflows = 0;
+      Button::tail = 0;
+      this->overflowsRead = 0;
+      this->level = this->buttonPressed();
+      this->since = millis();
+      attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), Button::isr, CHANGE);
 
       Serial.println("Setup Button Ready!");
 
       return 0;
    }
 
-   /* The loop method handles the main functionality. This loop method shall not contain any blocking function
-      calls. If you require delays, please use timing variable millis. Using this strategy the CPU performance is
-      maximized. If successfull the method returns 0, otherwise it returns an error number. The error numbers should be
-      documented in the concrete task that implements this loop.
-    *  
+   /* The interrupt of the button stores the time and the level of every edge in the ring, also the edges of the
+    * bouncing contacts. When the ring is full the edge is counted as an overflow.
+    *
     * @param None
+    * @return None
+    */
+   static void IRAM_ATTR isr() {
+      uint8_t h = Button::head;
+      uint8_t next = (h + 1) & (BUTTON_EDGES - 1);
+      Button::edges++;
+      if ( next == Button::tail ) {
+         Button::overflows++;
+         return;
+      }
+      Button::ring[h] = ((uint32_t) millis() << 1) | (digitalRead(BUTTON_PIN) == LOW ? 1 : 0);
+      Button::head = next; // Written last, the loop reads the edge from now on
+   }
+
+   /* The loop method handles the main functionality. The edges of the interrupt are handled in order: a level
+      is accepted when the next edge came after the settle time, or when the settle time has passed since the
+      last edge. The times of the press and the release are the times of the edges, so the debounce and the long
+      press are the same for a fast or a slow loop. Without edges the loop only compares two indexes.
+    *  
+    * @param millis: current time in ms
     * @return Zero is successfull and non-zero when an error occurred.
     */
    uint8_t loop(uint64_t millis) {
-      // low-pass filter to remove high freq of button press (anti-dender)
-      if ( this->buttonPressed() ) {
-         if ( this->value < 255 ) {
-            this->value = this->value + 1;
-         }
-      } else {
-         if ( this->value > 0 ) {
-            this->value = this->value - 1;
+      while ( Button::tail != Button::head ) {
+         uint32_t e = Button::ring[Button::tail];
+         uint64_t at = millis - ((((uint32_t) millis << 1) - (e & ~1UL)) >> 1); // Time of the edge in the 64 bits time
+         if ( at - this->since >= this->settle ) {
+            this->accept(this->level, this->since);
          }
+         this->level = (e & 1);
+         this->since = at;
+         Button::tail = (Button::tail + 1) & (BUTTON_EDGES - 1);
       }
 
-      bool currentDebouncedState = (this->value > 128);
+      if ( Button::overflows != this->overflowsRead ) { // Edges are lost, start again from the real level
+         this->overflowsRead = Button::overflows;
+         this->level = this->buttonPressed();
+         this->since = millis;
+      }
 
-      if (currentDebouncedState && !this->pressed) {
-         // Knop wordt net ingedrukt (Down-event)
-         this->pressed = true;
-         this->timer = millis;
-         this->longPressed = false;
-         this->longPressedRead = false;
-      } 
-      else if (currentDebouncedState && this->pressed) {
-         // Knop wordt vastgehouden
-         if (!this->longPressedRead && (millis - this->timer > 2000)) { // 2 seconden drempel
-            this->longPressed = true;
-            this->longPressedRead = true; // Markeer als afgehandeld voor deze sessie
-         }
+      if ( this->level != this->pressed && millis - this->since >= this->settle ) {
+         this->accept(this->level, this->since);
       }
-      else if (!currentDebouncedState && this->pressed) {
-         // Knop wordt losgelaten (Up-event)
-         if (!this->longPressedRead) {
-            // Alleen een korte klik als het geen long-press was
-            this->shortPressPending = true;
-         }
-         this->pressed = false;
+
+      // Knop wordt vastgehouden
+      if ( this->pressed && !this->longPressedRead && (millis - this->timer >= BUTTON_LONGPRESS) ) {
+         this->longPressed = true;
+         this->longPressedRead = true; // Markeer als afgehandeld voor deze sessie
       }
 
-       return 0;
+      // The gestures do not pass an edge that is not settled yet, it could be the release of a hold
+      this->gesture.loop(this->level != this->pressed ? this->since : millis);
+
+      return 0;
    }
 
    /* Return when the real button has been pressed. Cannot be used to determine whether it is pressed.
@@ -119,7 +198,35 @@ public:
     * @return True when pressed, otherwise false.
     */
    bool buttonPressed() {
-      return digitalRead(D3) == LOW;
+      return digitalRead(BUTTON_PIN) == LOW;
+   }
+
+   /* Set the time without an edge before the level of the button is accepted.
+    *
+    * @param settle: time in ms
+    * @return None
+    */
+   void setSettle(uint16_t settle) {
+      this->settle = settle;
+   }
+
+   /* Return the time of the last stable press or release. It is the time of the edge that started it,
+    * independent of the loop.
+    *
+    * @param None
+    * @return Time in ms.
+    */
+   uint64_t getChanged() {
+      return this->changed;
+   }
+
+   /* Return the total edges of the button since the setup, including the bouncing of the contacts.
+    *
+    * @param None
+    * @return Total edges.
+    */
+   uint32_t getEdges() {
+      return Button::edges;
    }
 
    bool isPressed() {
@@ -130,7 +237,26 @@ public:
       return false;
    }
 
-   /* Return when the button has been pressed for ten seconds.
+   /* Return the next gesture of the button: a single, double or triple click, a long press or a repeat while it is
+    * held. The gestures are stored until they are read.
+    *
+    * @param None
+    * @return The gesture, GESTURE_NONE when there is none.
+    */
+   ButtonGesture getGesture() {
+      return this->gesture.next();
+   }
+
+   /* Drop the gestures that are not read yet and ignore the button until it is released.
+    *
+    * @param None
+    * @return None
+    */
+   void cancelGesture() {
+      this->gesture.cancel();
+   }
+
+   /* Return when the button has been pressed for two seconds.
     *  
     * @param None
     * @return True when long pressed, otherwise false.
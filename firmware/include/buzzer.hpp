@@ -20,11 +20,26 @@
  * @updates    : 20-02-2024 (MS): Initial code.
  *               16-06-2024 (MS): Created the first release version.
  *               27-03-2026 (MS): Improved code and documentation.
- * @todo       : - Write a music engine to play music
+ *               19-10-2026 (MS): Sounds are sequences of tones played by the loop, nothing blocks anymore.
+ *               19-10-2026 (MS): The win music is a packed melody in flash.
+ *               19-10-2026 (MS): The tone is generated by timer1 instead of the global PWM.
+ *               19-10-2026 (MS): The sounds have a priority: alarm, feedback and ticking.
+ *               19-10-2026 (MS): The tick interval can be changed without starting the ticking.
+ *               19-10-2026 (MS): Sampled sounds are played by the sigma-delta modulator.
+ *               19-10-2026 (MS): Volume envelopes: the alarm is loud and the beeps are quiet.
+ *               19-10-2026 (MS): The half periods of the tones come from their tables, a new note is not divided.
+ *               19-10-2026 (MS): The tone of on is a feedback sound of the mixer, so the loop does not stop it.
+ * @todo       :
  */
 #include <driver.h>
 #include <Arduino.h>
 
+#include <sound.hpp>
+#include <mixer.hpp>
+#include <waveform.hpp>
+#include <samples.hpp>
+#include <melodies.hpp>
+
 // Buzzer functionality selection
 enum BuzzerFunctions {
    BUZZER_MUTE,
@@ -34,40 +49,35 @@ enum BuzzerFunctions {
    BUZZER_WIN,
 };
 
-// Enumeration for notes to use music
-enum Notes : uint32_t { // Octave 3 - https://forum.professionalcomposers.com/t/note-frequency-chart-free-guide/506
-   C  = 131,
-   CS = 139,
-   D  = 147,
-   DS = 156,
-   E  = 165,
-   F  = 175,
-   FS = 185,
-   G  = 196,
-   GS = 208,
-   A  = 220,
-   AS = 233,
-   B  = 247, 
-};
-
-#define TOTAL_NOTES 57
-
 /* Class: Buzzer
  * The buzzer class provides high level function to control the sound.
  */
 class Buzzer: public IDriver {
 private:
-   uint64_t timer; // Used for timing purposes to become non-blocking
-   uint32_t  value;
-   uint32_t notes[TOTAL_NOTES] = {E*2, E*2, B, C*2, D*2, D*2, C*2, B, A, A, A, C*2, E*2, E*2,
-                                  D*2, C*2, B, B, B, C*2, D*2, D*2, E*2, E*2, C*2, C*2, A, A, A,
-                                  D*2, D*2, F*2, A*2, A*2, G*2, F*2, E*2, E*2, E*2, C*2, E*2, E*2, 
-                                  D*2, C*2, B, B, B, C*2, D*2, D*2, E*2, E*2, C*2, C*2, A, A, A};
+   uint64_t timer; // Deadline of the next tick of the ticking bomb, 0 when it starts at the next loop
    BuzzerFunctions bf;
    uint16_t tickerTimer; // Speed og the ticker timer.
+   Mixer mixer; // Slots of the ticking, the feedback beeps and the alarm
+   uint16_t frequency; // Frequency of the tone that is played, 0 is off
+   EnvelopeGenerator envelope; // Volume of the tone, it can sound after the tone in the release
+   Waveform output; // Square wave on D8 by timer1
+   PcmPlayer pcm; // Sampled sound on D8 by timer1 and the sigma-delta modulator
+   Tone beepTones[2]; // Tones of beep with the given frequency and duration
+   Sound beepSound; // Sound of beep, the sequencer reads the tones with memcpy_P that also reads RAM
+
+   /* Start a feedback beep. It pre-empts the ticking, that continues silently and is heard again when the
+    * beep ends. During the alarm the beep is not heard.
+    *
+    * @param sound: the beep
+    * @return None
+    */
+   void playFeedback(const Sound* sound) {
+      this->mixer.play(SOUND_PRIORITY_FEEDBACK, sound, millis());
+   }
 
 public:
-    Buzzer(): timer(0), value(0), bf(BUZZER_MUTE), tickerTimer(600) {
+    Buzzer(): timer(0), bf(BUZZER_MUTE), tickerTimer(600), frequency(0),
+              output(D8), pcm(D8), beepTones{ TONE(1000, 5), TONE(0, 5) }, beepSound{ NULL, 2, 1, &ENVELOPE_BEEP } {
 
     }
 
@@ -83,82 +93,66 @@ public:
     * @return Zero is successfull and non-zero when an error occurred.
     */
    uint8_t setup() {
-      pinMode(D8, OUTPUT);
-      digitalWrite(D8, HIGH);
+      this->output.begin();
 
       Serial.println("Setup Buzzer Ready!");
 
       return 0;
    }
 
-   /* The loop method handles the main functionality. This loop method shall not contain any blocking function
-      calls. If you require delays, please use timing variable millis. Using this strategy the CPU performance is
-      maximized. If successfull the method returns 0, otherwise it returns an error number. The error numbers should be
-      documented in the concrete task that implements this loop.
+   /* The loop method handles the main functionality. The ticks of the ticking bomb are started on their
+    * deadline and the mixer plays the sound with the highest priority. The buzzer output is only changed
+    * when the frequency changes and the volume envelope on its control rate, so the loop never blocks on
+    * a sound. The half period of a new tone is read from the table of the tone, there is no division.
     *  
-    * @param None
+    * @param millis: current time in ms
     * @return Zero is successfull and non-zero when an error occurred.
     */
    uint8_t loop(uint64_t millis) {
       switch (this->bf) {
          case BUZZER_TICK_A:
-            if ( this->timer == 0 ) {
-               this->timer = millis;
-            } else {
-               if ( millis - this->timer > tickerTimer ) {
-                  this->beep(100);
-                  this->timer = millis;
-                  this->bf = BUZZER_TICK_B;
-               }
-            }
-            break;
-
          case BUZZER_TICK_B:
             if ( this->timer == 0 ) {
-               this->timer = millis;
-            } else {
-               if ( millis - this->timer > tickerTimer ) {
-                  this->beep(200);
-                  this->timer = millis;
-                  this->bf = BUZZER_TICK_A;
+               this->timer = millis + this->tickerTimer;
+            } else if ( millis >= this->timer ) {
+               this->mixer.play(SOUND_PRIORITY_TICKING, (this->bf == BUZZER_TICK_A ? &SOUND_TICK_A : &SOUND_TICK_B), millis);
+               this->bf = (this->bf == BUZZER_TICK_A ? BUZZER_TICK_B : BUZZER_TICK_A);
+               this->timer += this->tickerTimer;
+               if ( millis >= this->timer ) { // The loop was stalled, do not tick the missed ticks
+                  this->timer = millis + this->tickerTimer;
                }
             }
             break;
 
          case BUZZER_LOSE:
-            if ( this->timer == 0 ) {
-               this->timer = millis;
-            } else {
-               if ( millis - this->timer > 0 ) {
-                  this->beep(C);
-                  this->beep(D);
-                  this->beep(E);
-                  this->beep(F);
-                  this->beep(G);
-                  this->beep(A);
-                  this->beep(B);
-                  this->timer = millis;
-               }
-            }
-            break;
-
          case BUZZER_WIN:
-            if ( this->timer == 0 ) {
-               this->timer = millis;
-            } else {
-               if ( millis - this->timer > 200 ) {
-                  if ( value >= TOTAL_NOTES ) {
-                     value = 0;
-                  }
-                  on(this->notes[value++]);
-                  this->timer = millis;
-               }
-            }
-            break;
-
          case BUZZER_MUTE:
          default:
-            this->off();
+            break;
+      }
+
+      uint16_t f = this->mixer.loop(millis);
+      if ( this->pcm.isPlaying() ) { // The tones continue silently until the sample ends
+         this->pcm.loop();
+         return 0;
+      }
+      if ( f != this->frequency ) {
+         if ( f == 0 ) {
+            this->frequency = 0;
+            this->envelope.noteOff(millis);
+         } else {
+            this->envelope.noteOn(this->mixer.getEnvelope(), millis);
+            this->output.setDuty(this->envelope.getDuty());
+            this->output.play(this->mixer.getHalfPeriod());
+            this->frequency = f;
+         }
+      }
+
+      if ( this->envelope.loop(millis) ) {
+         this->output.setDuty(this->envelope.getDuty());
+      }
+      if ( this->frequency == 0 && !this->envelope.isActive() && this->output.getHalfPeriod() > 0 ) {
+         this->output.stop(); // The release of the tone ended
       }
 
       return 0;
@@ -170,9 +164,31 @@ public:
     * @return None
     */
    void startTicking (uint16_t timer = 600) {
-      this->off();
+      if ( this->bf != BUZZER_TICK_A && this->bf != BUZZER_TICK_B ) {
+         this->mixer.stop(SOUND_PRIORITY_ALARM);
+         this->timer = 0;
+         this->bf = BUZZER_TICK_A;
+      }
       this->tickerTimer = timer;
-      this->bf = BUZZER_TICK_A;
+   }
+
+   /* Set the interval of the ticking, without starting it. The next tick is still on the old interval, so the
+    * phase of the ticking is kept.
+    *
+    * @param interval: time between two ticks in ms
+    * @return None
+    */
+   void setTickInterval(uint16_t interval) {
+      this->tickerTimer = interval;
+   }
+
+   /* Return the interval of the ticking.
+    *
+    * @param None
+    * @return Time between two ticks in ms.
+    */
+   uint16_t getTickInterval() {
+      return this->tickerTimer;
    }
 
    /* Mute the buzzer
@@ -181,6 +197,8 @@ public:
     * @return None
     */
    void mute () {
+      this->pcm.stop();
+      this->mixer.stopAll();
       this->off();
       this->bf = BUZZER_MUTE;
    }
@@ -191,7 +209,8 @@ public:
     * @return None
     */
    void startWin () {
-      this->off();
+      this->mixer.stop(SOUND_PRIORITY_TICKING);
+      this->mixer.play(SOUND_PRIORITY_ALARM, &MELODY_WIN, millis());
       this->bf = BUZZER_WIN;
    }
 
@@ -201,57 +220,116 @@ public:
     * @return None
     */
    void startLose() {
-      this->off();
+      this->mixer.stop(SOUND_PRIORITY_TICKING);
+      this->mixer.play(SOUND_PRIORITY_ALARM, &SOUND_LOSE, millis());
       this->bf = BUZZER_LOSE;
    }
 
-   /* Make sound with the given frequency (default 1kHz).
+   /* Make sound with the given frequency (default 1kHz) until off is called. It is a feedback sound of one tone
+    * that repeats forever at full volume, so the loop keeps it playing and the alarm still pre-empts it. The
+    * half period is calculated here once, the sound starts at the next loop.
     *  
-    * @param f: frequency between 100 - 40000 Hz
+    * @param f: frequency between 20 - 10000 Hz
     * @return None
     */
    void on(uint32_t f = 1000) {
-      analogWriteFreq(f);
-      analogWrite(D8, 128);
+      this->beepTones[0] = { (uint16_t) f, 1000, Waveform::toHalfPeriod(f) };
+      this->beepSound = { this->beepTones, 1, 0, &ENVELOPE_ALARM };
+      this->playFeedback(&this->beepSound);
    }
 
-   /* Disable the sound (mute).
+   /* Disable the sound (mute). The tone of on or a beep is stopped, a ticking is heard again at the next loop.
     *  
     * @param None
     * @return None
     */   
    void off() {
-      analogWrite(D8, 0);
+      if ( this->mixer.isPlaying(SOUND_PRIORITY_FEEDBACK, &this->beepSound) ) {
+         this->mixer.stop(SOUND_PRIORITY_FEEDBACK);
+      }
+      this->envelope.stop();
+      this->output.stop();
+      this->frequency = 0;
    }
 
-   /* Make a beep sound, which is blocking for 10 ms on the given frequency.
+   /* Make a beep sound on the given frequency, followed by the same time of silence. It does not block, the
+    * beep is played by the loop.
     *  
-    * @param f: frequency between 100 - 40000 Hz
+    * @param f: frequency between 20 - 10000 Hz
+    * @param d: duration of the beep in ms
     * @return None
     */
    void beep(uint32_t f = 1000, unsigned long d = 5) {
-      this->on(f);
-      delay(d);
-      this->off();
-      delay(d);
+      this->beepTones[0] = { (uint16_t) f, (uint16_t) (d > 0 ? d : 1), Waveform::toHalfPeriod(f) };
+      this->beepTones[1] = { 0, (uint16_t) (d > 0 ? d : 1), 0 };
+      this->beepSound = { this->beepTones, 2, 1, &ENVELOPE_BEEP };
+      this->playFeedback(&this->beepSound);
    }
 
-   /* Make a beep sound for correct wire, which is blocking for 100 ms on the given frequency.
+   /* Make a beep sound for correct wire of 100 ms, it does not block.
     *  
     * @param None
     * @return None
     */
    void beepCorrectWire() {
-      this->beep(4000, 100);
+      this->playFeedback(&SOUND_CORRECT);
    }
 
-   /* Make a beep sound for incorrect, which is blocking for 100 ms on the given frequency.
+   /* Make a beep sound for incorrect wire of 100 ms, it does not block.
     *  
     * @param None
     * @return None
     */
    void beepNotCorrectWire() {
-      this->beep(500, 100);
+      this->playFeedback(&SOUND_NOT_CORRECT);
+   }
+
+   /* Play a sampled sound. It is heard over all tones, they continue silently and are heard again when the
+    * sample ends.
+    *
+    * @param sample: the sample, see samples.hpp
+    * @return None
+    */
+   void playSample(const Sample* sample) {
+      this->output.stop();
+      this->frequency = 0;
+      this->pcm.play(sample, millis());
+   }
+
+   /* Return the sample player.
+    *
+    * @param None
+    * @return The sample player.
+    */
+   PcmPlayer* getPcm() {
+      return &this->pcm;
+   }
+
+   /* Return the mixer of the sounds.
+    *
+    * @param None
+    * @return The mixer.
+    */
+   Mixer* getMixer() {
+      return &this->mixer;
+   }
+
+   /* Return the square wave output of the buzzer.
+    *
+    * @param None
+    * @return The waveform.
+    */
+   Waveform* getOutput() {
+      return &this->output;
+   }
+
+   /* Return the frequency on the buzzer output.
+    *
+    * @param None
+    * @return Frequency in Hz, 0 when it is off.
+    */
+   uint16_t getFrequency() {
+      return this->frequency;
    }
 
    /* The abstract reset function resets the task. If successfull the method returns 0, otherwise it returns an error
@@ -0,0 +1,399 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/display.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements a framebuffer for the HT16K33 7-segments display. The timer
+ *               draws in the framebuffer and in the loop only the digits that have been changed
+ *               are written to the display RAM. The I2C traffic is counted, so the bus time can
+ *               be monitored. The writes are enqueued in the I2C queue and not send blocking.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Writes are enqueued in the I2C queue.
+ *               19-10-2026 (MS): Digits are taken from the 7-segments font.
+ *               19-10-2026 (MS): Added the visible mask for animations.
+ *               19-10-2026 (MS): Added setTenths for the last minute of the countdown.
+ *               19-10-2026 (MS): Write several changed positions in one transaction.
+ *               19-10-2026 (MS): Initialize the HT16K33 again after a recovery of the bus.
+ * @todo       :
+ */
+#include <driver.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <HT16K33.h>
+
+#include <i2cqueue.hpp>
+#include <font.hpp>
+
+// Total positions in the display RAM of the 4 digit display: digit 0, digit 1, colon, digit 2, digit 3.
+#define DISPLAY_POSITIONS 5
+
+// Position of the colon in the display RAM.
+#define DISPLAY_COLON 2
+
+// Bit mask of all positions.
+#define DISPLAY_ALL 0x1F
+
+// Brightness 0-15 of the display.
+#define DISPLAY_BRIGHTNESS 4
+
+/* Class: Display
+ * The display class holds the frame that should be shown and writes the changes to the HT16K33.
+ */
+class Display: public IDriver {
+private:
+   I2CQueue* queue; // Queue that sends the transactions to the I2C bus
+   uint8_t address; // I2C address of the HT16K33
+   HT16K33 seg; // The library is used to initialize the chip and for the blink and brightness commands
+   uint8_t frame[DISPLAY_POSITIONS]; // Frame that should be shown
+   uint8_t shown[DISPLAY_POSITIONS]; // Frame that is in the display RAM
+   uint8_t dirty; // Bit mask of the positions that differ from the display RAM
+   uint8_t visible; // Bit mask of the positions that are visible, hidden positions are written blank
+   uint64_t timer; // Start of the current minute for the statistics
+   uint32_t bytes; // Total bytes written to the I2C bus
+   uint32_t bytesMinute; // Bytes written in the current minute
+   uint32_t bytesPerMinute; // Bytes written in the last complete minute
+   uint8_t blink; // Blink mode 0-3 of the HT16K33
+   bool blinkPending; // The blink mode is not enqueued yet, because the queue was full
+   bool initialize; // The HT16K33 should be initialized again, for example after a recovery of the bus
+
+   /* Enqueue the write of one position to the display RAM. The HT16K33 has two bytes per position,
+    * the 7-segment digits only use the first one.
+    *
+    * @param pos: position 0-4
+    * @return True when enqueued, false when the queue is full.
+    */
+   bool writePosition(uint8_t pos) {
+      uint8_t data[2] = { (uint8_t) (pos * 2), this->segments(pos) };
+      if ( !this->queue->available(1) || !this->queue->enqueue(this->address, data, sizeof(data)) ) {
+         return false;
+      }
+
+      this->shown[pos] = data[1];
+      this->bytes += 3; // Address byte, RAM pointer and data
+      this->bytesMinute += 3;
+
+      return true;
+   }
+
+   /* Enqueue the write of the positions lo to hi in one transaction. The HT16K33 increments the RAM pointer
+    * itself, so the second bytes of the positions in between are written as zero.
+    *
+    * @param lo: first position 0-4
+    * @param hi: last position 0-4
+    * @return True when enqueued, false when the queue is full.
+    */
+   bool writeSpan(uint8_t lo, uint8_t hi) {
+      uint8_t data[DISPLAY_POSITIONS * 2] = { (uint8_t) (lo * 2) };
+      uint8_t length = 1;
+      for ( uint8_t i=lo; i <= hi; i++ ) {
+         data[length++] = this->segments(i);
+         if ( i < hi ) {
+            data[length++] = 0x00;
+         }
+      }
+      if ( !this->queue->available(1) || !this->queue->enqueue(this->address, data, length) ) {
+         return false;
+      }
+
+      for ( uint8_t i=lo; i <= hi; i++ ) {
+         this->shown[i] = this->segments(i);
+      }
+      this->bytes += 1 + length; // Address byte, RAM pointer and data
+      this->bytesMinute += 1 + length;
+
+      return true;
+   }
+
+   /* Return the segments of a position that should be in the display RAM.
+    *
+    * @param pos: position 0-4
+    * @return The segments, blank when the position is hidden.
+    */
+   uint8_t segments(uint8_t pos) {
+      return (this->visible & (1 << pos)) ? this->frame[pos] : 0;
+   }
+
+   /* Enqueue the command of the blink mode. When the queue is full it stays pending and is enqueued at the
+    * next loop, like the dirty positions.
+    *
+    * @param None
+    * @return None
+    */
+   void writeBlink() {
+      uint8_t cmd = 0x81 | (this->blink << 1); // Display on with blink mode
+      this->blinkPending = !(this->queue->available(1) && this->queue->enqueue(this->address, &cmd, 1));
+   }
+
+   /* Update the dirty bit of a position.
+    *
+    * @param pos: position 0-4
+    * @return None
+    */
+   void update(uint8_t pos) {
+      if ( this->segments(pos) != this->shown[pos] ) {
+         this->dirty |= (1 << pos);
+      } else {
+         this->dirty &= ~(1 << pos);
+      }
+   }
+
+public:
+   Display(I2CQueue* queue = NULL, uint8_t address = 0x70): queue(queue), address(address), seg(address), dirty(0),
+                                                     visible(DISPLAY_ALL), timer(0), bytes(0), bytesMinute(0),
+                                                     bytesPerMinute(0), blink(0), blinkPending(false),
+                                                     initialize(false) {
+      for ( uint8_t i=0; i < DISPLAY_POSITIONS; i++ ) {
+         this->frame[i] = 0;
+         this->shown[i] = 0;
+      }
+   }
+
+   ~Display() {
+
+   }
+
+   /* The setup method initializes the task. This method should be called once at the startup of the board.
+    * The I2C bus should already be started. The complete frame is written at the next loop.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t setup() {
+      seg.begin();
+      seg.displayOn();
+      seg.setBrightness(DISPLAY_BRIGHTNESS);
+      seg.setDigits(4);
+
+      this->dirty = DISPLAY_ALL;
+
+      return 0;
+   }
+
+   /* The loop method enqueues the changed positions of the frame and updates the statistics. Several
+    * changed positions are written in one transaction when that takes fewer bytes than a transaction per
+    * position. When the queue is full, the positions stay dirty and are enqueued at the next loop.
+    *
+    * @param millis: current time in ms
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t loop(uint64_t millis) {
+      if ( this->initialize ) {
+         // Oscillator on, display on with the blink mode and the brightness, then the complete frame.
+         if ( !this->queue->available(3) ) {
+            return 0;
+         }
+         uint8_t commands[3] = { 0x21, (uint8_t) (0x81 | (this->blink << 1)), 0xE0 | DISPLAY_BRIGHTNESS };
+         for ( uint8_t i=0; i < 3; i++ ) {
+            this->queue->enqueue(this->address, &commands[i], 1);
+         }
+         this->initialize = false;
+         this->blinkPending = false; // The blink mode is part of the initialization
+         this->invalidate();
+      }
+
+      if ( this->blinkPending ) {
+         this->writeBlink();
+      }
+
+      if ( this->dirty != 0 ) {
+         uint8_t lo = 0;
+         uint8_t hi = DISPLAY_POSITIONS - 1;
+         uint8_t total = 0;
+         while ( !(this->dirty & (1 << lo)) ) lo++;
+         while ( !(this->dirty & (1 << hi)) ) hi--;
+         for ( uint8_t i=lo; i <= hi; i++ ) {
+            total += (this->dirty >> i) & 1;
+         }
+
+         // A transaction per position takes 3 bytes, one span takes 3 bytes plus 2 for every next position.
+         // With the same bytes the span is taken, because it is one transaction.
+         if ( total > 1 && 3 + 2 * (hi - lo) <= 3 * total ) {
+            if ( this->writeSpan(lo, hi) ) {
+               this->dirty = 0;
+            }
+         } else {
+            for ( uint8_t i=lo; i <= hi; i++ ) {
+               if ( (this->dirty & (1 << i)) && this->writePosition(i) ) {
+                  this->dirty &= ~(1 << i);
+               }
+            }
+         }
+      }
+
+      if ( millis - this->timer >= 60000 ) {
+         this->bytesPerMinute = this->bytesMinute;
+         this->bytesMinute = 0;
+         this->timer = millis;
+      }
+
+      return 0;
+   }
+
+   /* Set the segments of one position in the frame.
+    *
+    * @param pos: position 0-4, where 2 is the colon
+    * @param segments: the segments that are on
+    * @return None
+    */
+   void setPosition(uint8_t pos, uint8_t segments) {
+      this->frame[pos] = segments;
+      this->update(pos);
+   }
+
+   /* Set which positions are visible. The frame itself is kept, so the hidden positions come back
+    * when they are made visible again.
+    *
+    * @param mask: bit mask of the visible positions, DISPLAY_ALL for all
+    * @return None
+    */
+   void setVisible(uint8_t mask) {
+      this->visible = mask;
+      for ( uint8_t i=0; i < DISPLAY_POSITIONS; i++ ) {
+         this->update(i);
+      }
+   }
+
+   /* Set the segments of the four digits and the colon.
+    *
+    * @param digits: segments of the four digits
+    * @param colon: show the colon
+    * @return None
+    */
+   void setRaw(const uint8_t digits[4], bool colon) {
+      this->setPosition(0, digits[0]);
+      this->setPosition(1, digits[1]);
+      this->setPosition(3, digits[2]);
+      this->setPosition(4, digits[3]);
+      this->setPosition(DISPLAY_COLON, colon ? 2 : 0);
+   }
+
+   /* Set the time with leading zeros in the frame.
+    *
+    * @param left: 0-99 shown left of the colon
+    * @param right: 0-99 shown right of the colon
+    * @param colon: show the colon
+    * @return None
+    */
+   void setTime(uint8_t left, uint8_t right, bool colon) {
+      uint8_t digits[4] = { fontRead('0' + (left / 10) % 10),
+                            fontRead('0' + left % 10),
+                            fontRead('0' + (right / 10) % 10),
+                            fontRead('0' + right % 10) };
+      this->setRaw(digits, colon);
+   }
+
+   /* Set the seconds with tenths SS.t right aligned in the frame, without colon and leading zero.
+    *
+    * @param tenths: 0-999 tenths of seconds
+    * @return None
+    */
+   void setTenths(uint16_t tenths) {
+      uint8_t seconds = (tenths / 10) % 100;
+      uint8_t digits[4] = { 0x00,
+                            (uint8_t) (seconds >= 10 ? fontRead('0' + seconds / 10) : 0x00),
+                            (uint8_t) (fontRead('0' + seconds % 10) | FONT_DP),
+                            fontRead('0' + tenths % 10) };
+      this->setRaw(digits, false);
+   }
+
+   /* Blink the complete display by the HT16K33 itself. When the queue is full, the command is enqueued at the
+    * next loop.
+    *
+    * @param mode: 0 off, 1 2Hz, 2 1Hz, 3 0.5Hz
+    * @return None
+    */
+   void setBlink(uint8_t mode) {
+      this->blink = mode & 0x03;
+      this->writeBlink();
+   }
+
+   /* Initialize the HT16K33 again at the next loop and write the complete frame. The commands are enqueued,
+    * so it does not block like the setup.
+    *
+    * @param None
+    * @return None
+    */
+   void reinitialize() {
+      this->initialize = true;
+   }
+
+   /* Return whether the frame has changes that are not written yet.
+    *
+    * @param None
+    * @return True when the frame is dirty.
+    */
+   bool isDirty() {
+      return this->dirty != 0;
+   }
+
+   /* Mark the complete frame dirty, so it is written again at the next loop.
+    *
+    * @param None
+    * @return None
+    */
+   void invalidate() {
+      this->dirty = DISPLAY_ALL;
+   }
+
+   /* Return the total bytes that have been written to the display RAM over the I2C bus.
+    *
+    * @param None
+    * @return Total bytes.
+    */
+   uint32_t getBytes() {
+      return this->bytes;
+   }
+
+   /* Return the bytes that have been written to the display RAM in the last complete minute.
+    *
+    * @param None
+    * @return Bytes per minute.
+    */
+   uint32_t getBytesPerMinute() {
+      return this->bytesPerMinute;
+   }
+
+   /* The abstract reset function resets the task. If successfull the method returns 0, otherwise it returns an error
+       number.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t reset() {
+      this->invalidate();
+      return 0;
+   }
+
+   /* Put the task to sleep and if possible in low power consumption mode.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t sleep() {
+      return 0;
+   }
+
+   /* Awake the task so it runs again.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t wakeup() {
+      return 0;
+   }
+
+};
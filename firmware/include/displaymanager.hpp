@@ -0,0 +1,171 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/displaymanager.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the manager of the 7-segments displays on the I2C bus. Up to
+ *               eight HT16K33 displays can be connected on the addresses 0x70-0x77, for example the
+ *               countdown, a team score and a mistake counter. The manager starts the bus and in
+ *               every loop pass it enqueues the changes of all dirty displays in the I2C queue, so
+ *               they are sent in one bus pass.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Initialize the displays again after a recovery of the bus.
+ * @todo       :
+ */
+#include <driver.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <i2cqueue.hpp>
+#include <display.hpp>
+
+// Maximum displays, the HT16K33 has three address pins.
+#define DISPLAY_MANAGER_MAX 8
+
+// I2C address of the first display.
+#define DISPLAY_MANAGER_ADDRESS 0x70
+
+/* Class: DisplayManager
+ * The display manager class holds the framebuffers of all connected displays and writes their changes.
+ */
+class DisplayManager: public IDriver {
+private:
+   I2CQueue* queue; // Queue that sends the transactions to the I2C bus
+   Display displays[DISPLAY_MANAGER_MAX]; // Framebuffer of every display, display i is on address 0x70 + i
+   uint8_t total; // Total displays that are connected
+   uint8_t first; // Display that is enqueued first, it rotates so a full queue does not starve the last displays
+   uint32_t recoveries; // Total bus recoveries of the queue that have been handled
+
+public:
+   DisplayManager(I2CQueue* queue, uint8_t total = 1): queue(queue), total(total), first(0), recoveries(0) {
+      if ( this->total > DISPLAY_MANAGER_MAX ) {
+         this->total = DISPLAY_MANAGER_MAX;
+      } else if ( this->total == 0 ) { // There is always the display of the timer
+         this->total = 1;
+      }
+      for ( uint8_t i=0; i < this->total; i++ ) {
+         this->displays[i] = Display(queue, DISPLAY_MANAGER_ADDRESS + i);
+      }
+   }
+
+   ~DisplayManager() {
+
+   }
+
+   /* The setup method initializes the task. This method should be called once at the startup of the board.
+    * The I2C bus is started and every display is initialized.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t setup() {
+      this->queue->begin();
+      this->recoveries = this->queue->getRecoveries();
+
+      for ( uint8_t i=0; i < this->total; i++ ) {
+         this->displays[i].setup();
+      }
+
+      Serial.printf("Setup DisplayManager Ready with %d displays!\n", this->total);
+
+      return 0;
+   }
+
+   /* The loop method enqueues the changes of all dirty displays, so the I2C queue sends them in the same
+    * bus pass. A display that did not fit in the queue stays dirty and is enqueued first at the next loop.
+    * After a recovery of the bus, the displays are initialized again, because they could have lost power.
+    *
+    * @param millis: current time in ms
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t loop(uint64_t millis) {
+      if ( this->queue->getRecoveries() != this->recoveries ) {
+         this->recoveries = this->queue->getRecoveries();
+         for ( uint8_t i=0; i < this->total; i++ ) {
+            this->displays[i].reinitialize();
+         }
+      }
+
+      for ( uint8_t i=0; i < this->total; i++ ) {
+         this->displays[(this->first + i) % this->total].loop(millis);
+      }
+      this->first = (this->first + 1) % this->total;
+
+      return 0;
+   }
+
+   /* Return the framebuffer of a display.
+    *
+    * @param index: 0-7, the display on address 0x70 + index
+    * @return Pointer to the display, NULL when it is not connected.
+    */
+   Display* get(uint8_t index) {
+      return index < this->total ? &this->displays[index] : NULL;
+   }
+
+   /* Return the total displays that are connected.
+    *
+    * @param None
+    * @return Total displays.
+    */
+   uint8_t getTotal() {
+      return this->total;
+   }
+
+   /* Return the total bytes that have been written to all displays over the I2C bus.
+    *
+    * @param None
+    * @return Total bytes.
+    */
+   uint32_t getBytes() {
+      uint32_t bytes = 0;
+      for ( uint8_t i=0; i < this->total; i++ ) {
+         bytes += this->displays[i].getBytes();
+      }
+      return bytes;
+   }
+
+   /* The abstract reset function resets the task. All displays are written again at the next loop.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t reset() {
+      for ( uint8_t i=0; i < this->total; i++ ) {
+         this->displays[i].reset();
+      }
+      return 0;
+   }
+
+   /* Put the task to sleep and if possible in low power consumption mode.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t sleep() {
+      return 0;
+   }
+
+   /* Awake the task so it runs again.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t wakeup() {
+      return 0;
+   }
+};
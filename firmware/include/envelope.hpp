@@ -0,0 +1,222 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/envelope.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the volume envelopes of the buzzer tones: attack, decay, sustain
+ *               and release. The volume is the duty of the square wave, 50% is the loudest. The
+ *               level is updated on a fixed control rate by adding a step in 8.8 fixed point, the
+ *               step is calculated once per stage. There is no work per period of the tone.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): The feedback and the ticking have a release, the step does not overflow.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#define ENVELOPE_RATE 2 // Time in ms between two updates of the level
+
+/* Struct: Envelope
+ * The volume envelope of a tone. The times are in ms, a time of 0 jumps to the next stage.
+ */
+struct Envelope {
+   uint8_t attack; // Time to rise from silence to the volume
+   uint8_t decay; // Time to fall from the volume to the sustain level
+   uint8_t sustain; // Level while the tone is held, part of the volume (255 is the volume)
+   uint8_t release; // Time to fall to silence after the tone, it sounds in the silence after the tone
+   uint8_t volume; // Peak level, 255 is a duty of 50%
+};
+
+// The alarm at the end of the game is as loud as possible.
+const Envelope ENVELOPE_ALARM = { 0, 0, 255, 0, 255 };
+
+// Feedback of a cut wire: a soft start and loud, it fades out in the silence of 100 ms after the tone.
+const Envelope ENVELOPE_FEEDBACK = { 4, 30, 200, 40, 224 };
+
+// Ticking of the bomb: a short hit that decays and fades out in the silence of 5 ms after the tick.
+const Envelope ENVELOPE_TICKING = { 0, 4, 128, 4, 160 };
+
+// Beeps of the menu and the button: quiet in the classroom.
+const Envelope ENVELOPE_BEEP = { 1, 0, 255, 0, 48 };
+
+// Stages of the envelope.
+enum EnvelopeStage : uint8_t {
+   ENVELOPE_IDLE,
+   ENVELOPE_ATTACK,
+   ENVELOPE_DECAY,
+   ENVELOPE_SUSTAIN,
+   ENVELOPE_RELEASE,
+};
+
+/* Class: EnvelopeGenerator
+ * The envelope generator class calculates the level of the tone on the control rate.
+ */
+class EnvelopeGenerator {
+private:
+   const Envelope* envelope; // Envelope of the tone
+   EnvelopeStage stage;
+   uint16_t level; // Level in 8.8 fixed point
+   uint16_t target; // Level at the end of the stage in 8.8 fixed point
+   int32_t step; // Change of the level per update, a stage of one update changes the level up to 65280
+   uint64_t deadline; // Time in ms of the next update
+
+   /* Start a stage that moves the level to the target in the given time.
+    *
+    * @param stage: the stage
+    * @param target: level at the end of the stage, 0-255
+    * @param time: time in ms, 0 jumps to the target
+    * @return None
+    */
+   void enter(EnvelopeStage stage, uint8_t target, uint8_t time) {
+      this->stage = stage;
+      this->target = (uint16_t) target << 8;
+      uint8_t updates = time / ENVELOPE_RATE;
+      if ( updates == 0 ) {
+         this->level = this->target;
+         this->step = 0;
+      } else {
+         this->step = ((int32_t) this->target - this->level) / updates;
+         if ( this->step == 0 && this->level != this->target ) {
+            this->step = (this->target > this->level ? 1 : -1);
+         }
+      }
+   }
+
+   /* Go to the next stage when the level reached the target of the stage.
+    *
+    * @param None
+    * @return None
+    */
+   void next() {
+      while ( this->level == this->target ) {
+         switch ( this->stage ) {
+            case ENVELOPE_ATTACK:
+               this->enter(ENVELOPE_DECAY, (uint16_t) this->envelope->volume * this->envelope->sustain / 255,
+                           this->envelope->decay);
+               break;
+            case ENVELOPE_DECAY:
+               this->stage = ENVELOPE_SUSTAIN;
+               return;
+            case ENVELOPE_RELEASE:
+               this->stage = ENVELOPE_IDLE;
+               return;
+            default:
+               return;
+         }
+      }
+   }
+
+public:
+   EnvelopeGenerator(): envelope(NULL), stage(ENVELOPE_IDLE), level(0), target(0), step(0), deadline(0) {
+
+   }
+
+   /* Start the envelope of a tone from the current level, so a next tone does not click.
+    *
+    * @param envelope: the envelope
+    * @param millis: current time in ms
+    * @return None
+    */
+   void noteOn(const Envelope* envelope, uint64_t millis) {
+      this->envelope = envelope;
+      this->deadline = millis + ENVELOPE_RATE;
+      this->enter(ENVELOPE_ATTACK, envelope->volume, envelope->attack);
+      this->next();
+   }
+
+   /* Start the release of the tone.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void noteOff(uint64_t millis) {
+      if ( this->stage == ENVELOPE_IDLE ) {
+         return;
+      }
+      this->deadline = millis + ENVELOPE_RATE;
+      this->enter(ENVELOPE_RELEASE, 0, this->envelope->release);
+      this->next();
+   }
+
+   /* Stop the envelope at once.
+    *
+    * @param None
+    * @return None
+    */
+   void stop() {
+      this->stage = ENVELOPE_IDLE;
+      this->level = 0;
+   }
+
+   /* The loop method updates the level on the control rate. A late loop does the missed updates at once.
+    *
+    * @param millis: current time in ms
+    * @return True when the level changed.
+    */
+   bool loop(uint64_t millis) {
+      if ( this->step == 0 || this->stage == ENVELOPE_IDLE || this->stage == ENVELOPE_SUSTAIN || millis < this->deadline ) {
+         return false;
+      }
+
+      do {
+         int32_t level = (int32_t) this->level + this->step;
+         bool reached = (this->step > 0 ? level >= this->target : level <= this->target);
+         this->level = (reached ? this->target : (uint16_t) level);
+         if ( reached ) {
+            this->next();
+         }
+         this->deadline += ENVELOPE_RATE;
+      } while ( millis >= this->deadline && this->step != 0 && this->stage != ENVELOPE_IDLE &&
+                this->stage != ENVELOPE_SUSTAIN );
+
+      return true;
+   }
+
+   /* Return whether the tone is heard.
+    *
+    * @param None
+    * @return True when the stage is not idle.
+    */
+   bool isActive() {
+      return this->stage != ENVELOPE_IDLE;
+   }
+
+   /* Return the stage of the envelope.
+    *
+    * @param None
+    * @return The stage.
+    */
+   EnvelopeStage getStage() {
+      return this->stage;
+   }
+
+   /* Return the level of the tone.
+    *
+    * @param None
+    * @return Level 0-255.
+    */
+   uint8_t getLevel() {
+      return this->level >> 8;
+   }
+
+   /* Return the duty of the square wave for the level.
+    *
+    * @param None
+    * @return Duty 0-128 of 256, 128 is 50%.
+    */
+   uint8_t getDuty() {
+      return (uint8_t) (((this->level >> 8) + 1) >> 1);
+   }
+};
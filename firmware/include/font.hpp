@@ -0,0 +1,221 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/font.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the ASCII font of the 7-segments display. The font is
+ *               defined once by the constexpr function fontGlyph. The PROGMEM table is
+ *               generated from it by the compiler, and fixed texts are rendered at compile
+ *               time with fontText, so they cost nothing at runtime.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+// First and last character in the font table.
+#define FONT_FIRST 32
+#define FONT_LAST  127
+
+// Segments of the 7-segments display.
+#define FONT_A  0x01
+#define FONT_B  0x02
+#define FONT_C  0x04
+#define FONT_D  0x08
+#define FONT_E  0x10
+#define FONT_F  0x20
+#define FONT_G  0x40
+#define FONT_DP 0x80
+
+/* Struct: FontText
+ * The segments of the four digits of the display.
+ */
+struct FontText {
+   uint8_t digits[4];
+};
+
+/* Return the segments of a character. Lowercase letters without their own shape use the
+ * uppercase shape. Characters that cannot be shown are blank.
+ *
+ * @param c: ASCII character
+ * @return The segments of the character.
+ */
+constexpr uint8_t fontGlyph(char c) {
+   switch (c) {
+      case '0': return 0x3F;
+      case '1': return 0x06;
+      case '2': return 0x5B;
+      case '3': return 0x4F;
+      case '4': return 0x66;
+      case '5': return 0x6D;
+      case '6': return 0x7D;
+      case '7': return 0x07;
+      case '8': return 0x7F;
+      case '9': return 0x6F;
+      case 'A': return 0x77;
+      case 'a': return 0x5F;
+      case 'B': case 'b': return 0x7C;
+      case 'C': return 0x39;
+      case 'c': return 0x58;
+      case 'D': case 'd': return 0x5E;
+      case 'E': return 0x79;
+      case 'e': return 0x7B;
+      case 'F': case 'f': return 0x71;
+      case 'G': return 0x3D;
+      case 'g': return 0x6F;
+      case 'H': return 0x76;
+      case 'h': return 0x74;
+      case 'I': return 0x30;
+      case 'i': return 0x10;
+      case 'J': case 'j': return 0x1E;
+      case 'K': case 'k': return 0x75;
+      case 'L': return 0x38;
+      case 'l': return 0x30;
+      case 'M': case 'm': return 0x37;
+      case 'N': case 'n': return 0x54;
+      case 'O': return 0x3F;
+      case 'o': return 0x5C;
+      case 'P': case 'p': return 0x73;
+      case 'Q': case 'q': return 0x67;
+      case 'R': case 'r': return 0x50;
+      case 'S': case 's': return 0x6D;
+      case 'T': case 't': return 0x78;
+      case 'U': return 0x3E;
+      case 'u': case 'V': case 'v': return 0x1C;
+      case 'W': case 'w': return 0x2A;
+      case 'X': case 'x': return 0x76;
+      case 'Y': case 'y': return 0x6E;
+      case 'Z': case 'z': return 0x5B;
+      case '-': return FONT_G;
+      case '_': return FONT_D;
+      case '=': return FONT_G | FONT_D;
+      case '\'': return FONT_B;
+      case '"': return FONT_B | FONT_F;
+      case '[': case '(': return 0x39;
+      case ']': case ')': return 0x0F;
+      case '?': return 0x53;
+      case '*': return 0x63; // Degree sign
+      case '/': return 0x52;
+      case '\\': return 0x64;
+      case '|': return 0x30;
+      case '.': case ',': return FONT_DP;
+      default: return 0x00;
+   }
+}
+
+// Generate eight table entries from the font.
+#define FONT_ROW(c) fontGlyph(c), fontGlyph(c+1), fontGlyph(c+2), fontGlyph(c+3), \
+                    fontGlyph(c+4), fontGlyph(c+5), fontGlyph(c+6), fontGlyph(c+7)
+
+// The font table in flash, generated at compile time.
+const uint8_t FONT[FONT_LAST - FONT_FIRST + 1] PROGMEM = { FONT_ROW(32), FONT_ROW(40), FONT_ROW(48), FONT_ROW(56),
+                                                           FONT_ROW(64), FONT_ROW(72), FONT_ROW(80), FONT_ROW(88),
+                                                           FONT_ROW(96), FONT_ROW(104), FONT_ROW(112), FONT_ROW(120) };
+
+/* Return the segments of a character from the font table in flash.
+ *
+ * @param c: ASCII character
+ * @return The segments of the character.
+ */
+inline uint8_t fontRead(char c) {
+   uint8_t i = (uint8_t) c;
+   if ( i < FONT_FIRST || i > FONT_LAST ) {
+      return 0x00;
+   }
+   return pgm_read_byte(&FONT[i - FONT_FIRST]);
+}
+
+/* Return whether the character on index i is a dot that is shown as the decimal point of the
+ * character before it. A dot after another dot or comma takes its own position.
+ *
+ * @param text: the text
+ * @param i: index in the text
+ * @return True when the dot merges with the character before.
+ */
+constexpr bool fontMerges(const char* text, uint8_t i) {
+   return text[i] == '.' && i > 0 && text[i-1] != '.' && text[i-1] != ',';
+}
+
+/* Render the first four positions of a text with the given glyph function. A dot is shown
+ * as the decimal point of the character before it, so "12.5" takes three positions.
+ *
+ * @param text: the text, shorter texts are filled with blanks
+ * @return The segments of the four digits.
+ */
+template <uint8_t (*glyph)(char)>
+constexpr FontText fontRenderWith(const char* text) {
+   FontText t = { { 0, 0, 0, 0 } };
+   int8_t pos = -1;
+   for ( uint8_t i=0; text[i] != '\0'; i++ ) {
+      if ( fontMerges(text, i) ) {
+         t.digits[pos] |= FONT_DP;
+      } else if ( pos < 3 ) {
+         t.digits[++pos] = glyph(text[i]);
+      } else {
+         break;
+      }
+   }
+   return t;
+}
+
+/* Render a text at compile time, for example: constexpr FontText LOSE = fontText("LOSE");
+ *
+ * @param text: the text
+ * @return The segments of the four digits.
+ */
+constexpr FontText fontText(const char* text) {
+   return fontRenderWith<fontGlyph>(text);
+}
+
+/* Render a text at runtime with the font table in flash.
+ *
+ * @param text: the text
+ * @return The segments of the four digits.
+ */
+inline FontText fontRender(const char* text) {
+   return fontRenderWith<fontRead>(text);
+}
+
+/* Return the total positions that a text takes on the display.
+ *
+ * @param text: the text
+ * @return Total positions.
+ */
+inline uint8_t fontLength(const char* text) {
+   uint8_t length = 0;
+   for ( uint8_t i=0; text[i] != '\0'; i++ ) {
+      if ( !fontMerges(text, i) ) {
+         length++;
+      }
+   }
+   return length;
+}
+
+/* Return the text from the given position on the display, the counterpart of fontLength.
+ *
+ * @param text: the text
+ * @param pos: position to skip to
+ * @return Pointer into the text.
+ */
+inline const char* fontSkip(const char* text, uint8_t pos) {
+   uint8_t i = 0;
+   while ( text[i] != '\0' && pos > 0 ) {
+      i++;
+      if ( !fontMerges(text, i) ) {
+         pos--;
+      }
+   }
+   return &text[i];
+}
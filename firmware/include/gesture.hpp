@@ -0,0 +1,232 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/gesture.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the recognition of the gestures of the button: single, double and
+ *               triple click, long press and hold to repeat with acceleration. It is a state machine
+ *               that gets the debounced press and release with the time of their edge, so the gestures
+ *               do not depend on the speed of the loop. All timeouts are calculated from the times of the
+ *               edges. When the button is idle the loop only checks the state.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#define GESTURE_CLICK_GAP      300 // Time in ms after a release that a next click is part of the same gesture
+#define GESTURE_HOLD           500 // Time in ms that the button is held before it repeats
+#define GESTURE_LONGPRESS      2000 // Time in ms that the button is held for a long press
+#define GESTURE_REPEAT_FIRST   250 // Time in ms between the first two repeats
+#define GESTURE_REPEAT_MIN     50 // Shortest time in ms between two repeats
+#define GESTURE_EVENTS         8 // Clicks and long presses that are stored until they are read, a power of 2
+
+// Gestures of the button.
+enum ButtonGesture : uint8_t {
+   GESTURE_NONE,
+   GESTURE_CLICK,
+   GESTURE_DOUBLE_CLICK,
+   GESTURE_TRIPLE_CLICK,
+   GESTURE_LONG_PRESS,
+   GESTURE_REPEAT,
+};
+
+// States of the recognition.
+enum GestureState : uint8_t {
+   GESTURE_IDLE, // Nothing happens
+   GESTURE_DOWN, // Pressed, not yet held
+   GESTURE_UP, // Released after a click, waiting for a next click
+   GESTURE_HELD, // Held, it repeats
+   GESTURE_CANCELED, // Ignored until it is released
+};
+
+/* Class: Gesture
+ * The gesture class recognizes the gestures from the press and release of the button.
+ */
+class Gesture {
+private:
+   GestureState state;
+   uint8_t clicks; // Clicks of the gesture so far
+   uint64_t time; // Time in ms of the last press or release
+   uint64_t deadline; // Time in ms of the next repeat
+   uint16_t interval; // Time in ms between the repeats, it gets shorter while it is held
+   bool longPressed; // The long press of this hold is reported
+   ButtonGesture events[GESTURE_EVENTS]; // Gestures that are not read yet
+   uint8_t head;
+   uint8_t tail;
+   uint16_t repeats; // Repeats that are not read yet, they are counted so they do not fill the events
+   uint32_t lost; // Gestures that did not fit
+
+   /* Store a gesture until it is read.
+    *
+    * @param gesture: the gesture
+    * @return None
+    */
+   void emit(ButtonGesture gesture) {
+      uint8_t next = (this->head + 1) & (GESTURE_EVENTS - 1);
+      if ( next == this->tail ) {
+         this->lost++;
+         return;
+      }
+      this->events[this->head] = gesture;
+      this->head = next;
+   }
+
+   /* Store the clicks of the gesture, more than three clicks is a triple click.
+    *
+    * @param None
+    * @return None
+    */
+   void emitClicks() {
+      if ( this->clicks > 0 ) {
+         this->emit(this->clicks == 1 ? GESTURE_CLICK : (this->clicks == 2 ? GESTURE_DOUBLE_CLICK : GESTURE_TRIPLE_CLICK));
+         this->clicks = 0;
+      }
+   }
+
+public:
+   Gesture(): state(GESTURE_IDLE), clicks(0), time(0), deadline(0), interval(0), longPressed(false),
+              events{ GESTURE_NONE }, head(0), tail(0), repeats(0), lost(0) {
+
+   }
+
+   /* The button is pressed. The timeouts until the press are handled first.
+    *
+    * @param at: time in ms of the edge of the press
+    * @return None
+    */
+   void press(uint64_t at) {
+      this->loop(at);
+      this->state = GESTURE_DOWN;
+      this->time = at;
+      this->longPressed = false;
+   }
+
+   /* The button is released. A release before the hold time is a click, the third click ends the gesture at
+    * once.
+    *
+    * @param at: time in ms of the edge of the release
+    * @return None
+    */
+   void release(uint64_t at) {
+      this->loop(at);
+      if ( this->state == GESTURE_DOWN ) {
+         this->clicks++;
+         this->state = GESTURE_UP;
+         this->time = at;
+         if ( this->clicks >= 3 ) {
+            this->emitClicks();
+            this->state = GESTURE_IDLE;
+         }
+      } else {
+         this->state = GESTURE_IDLE;
+      }
+   }
+
+   /* The loop method handles the timeouts: the end of the clicks, the start of the hold, the repeats and the
+    * long press. Repeats that were missed by a slow loop are all stored, so the total repeats only depend on
+    * the time that the button is held.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void loop(uint64_t millis) {
+      switch ( this->state ) {
+         case GESTURE_IDLE:
+         case GESTURE_CANCELED:
+            return;
+
+         case GESTURE_UP:
+            if ( millis - this->time >= GESTURE_CLICK_GAP ) {
+               this->emitClicks();
+               this->state = GESTURE_IDLE;
+            }
+            return;
+
+         case GESTURE_DOWN:
+            if ( millis - this->time < GESTURE_HOLD ) {
+               return;
+            }
+            this->emitClicks(); // The clicks before the hold are a gesture of their own
+            this->state = GESTURE_HELD;
+            this->deadline = this->time + GESTURE_HOLD;
+            this->interval = GESTURE_REPEAT_FIRST;
+            // fall through
+
+         case GESTURE_HELD:
+            while ( millis >= this->deadline ) {
+               this->repeats++;
+               this->deadline += this->interval;
+               this->interval = (this->interval * 3 / 4 < GESTURE_REPEAT_MIN ? GESTURE_REPEAT_MIN : this->interval * 3 / 4);
+            }
+            if ( !this->longPressed && millis - this->time >= GESTURE_LONGPRESS ) {
+               this->emit(GESTURE_LONG_PRESS);
+               this->longPressed = true;
+            }
+            return;
+      }
+   }
+
+   /* Drop the gestures that are not read and ignore the button until it is released, so a hold that confirmed a
+    * choice does not repeat in the next menu.
+    *
+    * @param None
+    * @return None
+    */
+   void cancel() {
+      this->tail = this->head;
+      this->repeats = 0;
+      this->clicks = 0;
+      if ( this->state != GESTURE_IDLE ) {
+         this->state = GESTURE_CANCELED;
+      }
+   }
+
+   /* Return the next gesture that is not read yet. The clicks and long presses are returned before the repeats.
+    *
+    * @param None
+    * @return The gesture, GESTURE_NONE when there is none.
+    */
+   ButtonGesture next() {
+      if ( this->tail == this->head ) {
+         if ( this->repeats > 0 ) {
+            this->repeats--;
+            return GESTURE_REPEAT;
+         }
+         return GESTURE_NONE;
+      }
+      ButtonGesture gesture = this->events[this->tail];
+      this->tail = (this->tail + 1) & (GESTURE_EVENTS - 1);
+      return gesture;
+   }
+
+   /* Return the state of the recognition.
+    *
+    * @param None
+    * @return The state.
+    */
+   GestureState getState() {
+      return this->state;
+   }
+
+   /* Return the total gestures that were lost because they were not read.
+    *
+    * @param None
+    * @return Total lost gestures.
+    */
+   uint32_t getLost() {
+      return this->lost;
+   }
+};
@@ -0,0 +1,447 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/i2cqueue.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements a queue for I2C write transactions. Drivers enqueue their
+ *               transactions and the queue sends them in the loop within a time budget per loop
+ *               pass, so the I2C bus never takes a large part of one loop pass. The latency from
+ *               enqueue to completion is recorded.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Transactions of a complete display and the busy time of the bus.
+ *               19-10-2026 (MS): Retries, timeouts and the recovery of a hung bus.
+ *               19-10-2026 (MS): A not acknowledged transaction is dropped without a recovery, setup keeps the queue.
+ * @todo       :
+ */
+#include <driver.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Total transactions that can be waiting in the queue.
+#define I2C_QUEUE_SIZE 16
+
+// Maximum data bytes of one transaction, the RAM pointer and the 9 bytes of a complete 4 digit display.
+#define I2C_QUEUE_DATA 10
+
+// Default time budget in us per loop pass. A transaction of 3 bytes takes about 80 us on 400kHz.
+#define I2C_QUEUE_BUDGET 200
+
+// Clock of the I2C bus.
+#define I2C_QUEUE_CLOCK 400000
+
+// Pins of the I2C bus on the D1 mini: SDA is D2 and SCL is D1.
+#define I2C_QUEUE_SDA D2
+#define I2C_QUEUE_SCL D1
+
+// A transaction that takes longer than this time in us has hung the bus. It is also the clock stretch limit.
+#define I2C_QUEUE_TIMEOUT 1000
+
+// Total times a not acknowledged transaction is sent again before it is dropped.
+#define I2C_QUEUE_RETRIES 2
+
+// Minimum time in ms between two bus recoveries, the queue waits when the bus is still not working.
+#define I2C_QUEUE_HOLDOFF 500
+
+// Results of Wire.endTransmission.
+#define I2C_NACK_ADDRESS 2
+#define I2C_NACK_DATA    3
+
+/* Struct: I2CTransaction
+ * One write transaction that is waiting in the queue.
+ */
+struct I2CTransaction {
+   uint8_t address; // I2C address of the device
+   uint8_t length; // Total data bytes
+   uint8_t retries; // Total times the transaction has been sent again
+   uint8_t data[I2C_QUEUE_DATA]; // Data bytes
+   uint32_t enqueued; // Time in us when the transaction was enqueued
+};
+
+/* Class: I2CQueue
+ * The queue class sends the enqueued transactions incrementally in the loop.
+ */
+class I2CQueue: public IDriver {
+private:
+   I2CTransaction ring[I2C_QUEUE_SIZE]; // Ring buffer with the waiting transactions
+   uint8_t head; // Next transaction to send
+   uint8_t count; // Total transactions waiting
+   uint8_t countMax; // Highest total transactions waiting
+   uint32_t budget; // Time budget in us per loop pass
+   uint32_t completed; // Total transactions that have been sent
+   uint32_t dropped; // Total transactions that did not fit in the queue
+   uint32_t errors; // Total transactions that failed after the retries
+   uint32_t nacks; // Total times a transaction was not acknowledged
+   uint32_t retries; // Total times a transaction was sent again
+   uint32_t timeouts; // Total transactions that hung the bus
+   uint32_t recoveries; // Total bus recoveries
+   uint64_t holdoff; // Time in ms until the queue sends again after a recovery
+   uint64_t latencySum; // Sum of the latencies in us to calculate the average
+   uint32_t latencyMax; // Highest latency in us from enqueue to completion
+   uint32_t durationMax; // Highest time in us of one transaction on the bus
+   uint64_t busy; // Total time in us that the bus was busy with the transactions
+
+public:
+   I2CQueue(uint32_t budget = I2C_QUEUE_BUDGET): head(0), count(0), countMax(0), budget(budget), completed(0),
+                                                  dropped(0), errors(0), nacks(0), retries(0), timeouts(0), recoveries(0),
+                                                  holdoff(0), latencySum(0), latencyMax(0), durationMax(0), busy(0) {
+
+   }
+
+   ~I2CQueue() {
+
+   }
+
+   /* The setup method initializes the task. This method should be called once at the startup of the board.
+    * The I2C bus itself is started with begin by the driver of the connected devices. The queue is not
+    * cleared, because these drivers can enqueue the initialization of their devices before this setup.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t setup() {
+      Serial.println("Setup I2C queue Ready!");
+
+      return 0;
+   }
+
+   /* Recover a hung bus. A slave that holds SDA low is in the middle of a byte, so SCL is clocked until it
+    * releases SDA (at most 9 clocks) and a stop condition is generated. Then the bus is started again. The
+    * failed transaction should already be removed, the other waiting transactions are discarded, because
+    * the devices are initialized again by their drivers.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void recover(uint64_t millis) {
+      pinMode(I2C_QUEUE_SDA, INPUT_PULLUP);
+      pinMode(I2C_QUEUE_SCL, OUTPUT_OPEN_DRAIN);
+      for ( uint8_t i=0; i < 9 && digitalRead(I2C_QUEUE_SDA) == LOW; i++ ) {
+         digitalWrite(I2C_QUEUE_SCL, LOW);
+         delayMicroseconds(5);
+         digitalWrite(I2C_QUEUE_SCL, HIGH);
+         delayMicroseconds(5);
+      }
+
+      // Stop condition: SDA goes high while SCL is high.
+      pinMode(I2C_QUEUE_SDA, OUTPUT_OPEN_DRAIN);
+      digitalWrite(I2C_QUEUE_SDA, LOW);
+      delayMicroseconds(5);
+      digitalWrite(I2C_QUEUE_SDA, HIGH);
+      delayMicroseconds(5);
+
+      this->begin();
+
+      this->dropped += this->count;
+      this->head = 0;
+      this->count = 0;
+      this->recoveries++;
+      this->holdoff = millis + I2C_QUEUE_HOLDOFF;
+
+      Serial.printf("I2C bus recovered (%u)\n", this->recoveries);
+   }
+
+   /* Start the I2C bus. A device that stretches the clock longer than the timeout ends the transaction, so
+    * it never blocks the loop.
+    *
+    * @param None
+    * @return None
+    */
+   void begin() {
+      Wire.begin();
+      Wire.setClock(I2C_QUEUE_CLOCK);
+      Wire.setClockStretchLimit(I2C_QUEUE_TIMEOUT);
+   }
+
+   /* The loop method sends the waiting transactions until the time budget of this loop pass is used. At
+    * least one transaction is send every pass, so the queue always drains. A transaction that is not
+    * acknowledged is sent again at the next pass and dropped when the retries are used. The bus itself is
+    * fine then, a device is missing or busy, so the other transactions are still sent. When a transaction
+    * hung the bus, the bus is recovered. After a recovery the queue waits a moment, so a broken cable does
+    * not take the time of every loop pass.
+    *
+    * @param millis: current time in ms
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t loop(uint64_t millis) {
+      if ( millis < this->holdoff ) {
+         return 0;
+      }
+
+      uint32_t start = micros();
+
+      while ( this->count > 0 ) {
+         I2CTransaction* t = &this->ring[this->head];
+         uint32_t begin = micros();
+
+         Wire.beginTransmission(t->address);
+         for ( uint8_t i=0; i < t->length; i++ ) {
+            Wire.write(t->data[i]);
+         }
+         uint8_t result = Wire.endTransmission();
+
+         uint32_t end = micros();
+         this->busy += end - begin;
+
+         if ( result == I2C_NACK_ADDRESS || result == I2C_NACK_DATA ) {
+            this->nacks++;
+            if ( t->retries < I2C_QUEUE_RETRIES ) {
+               t->retries++;
+               this->retries++;
+               break; // Sent again at the next pass
+            }
+            this->errors++;
+            this->head = (this->head + 1) % I2C_QUEUE_SIZE;
+            this->count--;
+         } else if ( result != 0 || end - begin > I2C_QUEUE_TIMEOUT ) {
+            this->timeouts++;
+            this->errors++;
+            this->count--;
+            this->recover(millis);
+            break;
+         } else {
+            uint32_t latency = end - t->enqueued;
+            this->latencySum += latency;
+            if ( latency > this->latencyMax ) {
+               this->latencyMax = latency;
+            }
+            if ( end - begin > this->durationMax ) {
+               this->durationMax = end - begin;
+            }
+            this->completed++;
+
+            this->head = (this->head + 1) % I2C_QUEUE_SIZE;
+            this->count--;
+         }
+
+         if ( end - start >= this->budget ) {
+            break;
+         }
+      }
+
+      return 0;
+   }
+
+   /* Enqueue a write transaction.
+    *
+    * @param address: I2C address of the device
+    * @param data: the bytes to write
+    * @param length: total bytes (max I2C_QUEUE_DATA)
+    * @return True when enqueued, false when the queue is full.
+    */
+   bool enqueue(uint8_t address, const uint8_t* data, uint8_t length) {
+      if ( this->count >= I2C_QUEUE_SIZE || length > I2C_QUEUE_DATA ) {
+         this->dropped++;
+         return false;
+      }
+
+      I2CTransaction* t = &this->ring[(this->head + this->count) % I2C_QUEUE_SIZE];
+      t->address = address;
+      t->length = length;
+      t->retries = 0;
+      for ( uint8_t i=0; i < length; i++ ) {
+         t->data[i] = data[i];
+      }
+      t->enqueued = micros();
+
+      this->count++;
+      if ( this->count > this->countMax ) {
+         this->countMax = this->count;
+      }
+
+      return true;
+   }
+
+   /* Return whether there is space for the given total transactions.
+    *
+    * @param n: total transactions
+    * @return True when they fit in the queue.
+    */
+   bool available(uint8_t n) {
+      return I2C_QUEUE_SIZE - this->count >= n;
+   }
+
+   /* Return whether all transactions have been sent.
+    *
+    * @param None
+    * @return True when the queue is empty.
+    */
+   bool isEmpty() {
+      return this->count == 0;
+   }
+
+   /* Return the total transactions that are waiting.
+    *
+    * @param None
+    * @return Total transactions.
+    */
+   uint8_t getCount() {
+      return this->count;
+   }
+
+   /* Return the total transactions that have been sent.
+    *
+    * @param None
+    * @return Total transactions.
+    */
+   uint32_t getCompleted() {
+      return this->completed;
+   }
+
+   /* Return the total transactions that did not fit in the queue.
+    *
+    * @param None
+    * @return Total transactions.
+    */
+   uint32_t getDropped() {
+      return this->dropped;
+   }
+
+   /* Return the total transactions that failed after the retries or hung the bus.
+    *
+    * @param None
+    * @return Total transactions.
+    */
+   uint32_t getErrors() {
+      return this->errors;
+   }
+
+   /* Return the total times a transaction was not acknowledged.
+    *
+    * @param None
+    * @return Total not acknowledged.
+    */
+   uint32_t getNacks() {
+      return this->nacks;
+   }
+
+   /* Return the total times a transaction was sent again.
+    *
+    * @param None
+    * @return Total retries.
+    */
+   uint32_t getRetries() {
+      return this->retries;
+   }
+
+   /* Return the total transactions that hung the bus.
+    *
+    * @param None
+    * @return Total timeouts.
+    */
+   uint32_t getTimeouts() {
+      return this->timeouts;
+   }
+
+   /* Return the total bus recoveries. The drivers of the devices compare it with their last value to know
+    * that their device should be initialized again.
+    *
+    * @param None
+    * @return Total recoveries.
+    */
+   uint32_t getRecoveries() {
+      return this->recoveries;
+   }
+
+   /* Return the highest total transactions that were waiting in the queue.
+    *
+    * @param None
+    * @return Total transactions.
+    */
+   uint8_t getCountMax() {
+      return this->countMax;
+   }
+
+   /* Return the average latency from enqueue to completion.
+    *
+    * @param None
+    * @return Latency in us.
+    */
+   uint32_t getLatencyAverage() {
+      return this->completed > 0 ? this->latencySum / this->completed : 0;
+   }
+
+   /* Return the highest latency from enqueue to completion.
+    *
+    * @param None
+    * @return Latency in us.
+    */
+   uint32_t getLatencyMax() {
+      return this->latencyMax;
+   }
+
+   /* Return the highest time of one transaction on the bus.
+    *
+    * @param None
+    * @return Duration in us.
+    */
+   uint32_t getDurationMax() {
+      return this->durationMax;
+   }
+
+   /* Return the total time that the bus was busy, to calculate the bus utilization.
+    *
+    * @param None
+    * @return Total time in us.
+    */
+   uint64_t getBusy() {
+      return this->busy;
+   }
+
+   /* The abstract reset function resets the task. The waiting transactions and the statistics are cleared. If
+       successfull the method returns 0, otherwise it returns an error number.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t reset() {
+      this->head = 0;
+      this->count = 0;
+      this->countMax = 0;
+      this->completed = 0;
+      this->dropped = 0;
+      this->errors = 0;
+      this->nacks = 0;
+      this->retries = 0;
+      this->timeouts = 0;
+      this->recoveries = 0;
+      this->holdoff = 0;
+      this->latencySum = 0;
+      this->latencyMax = 0;
+      this->durationMax = 0;
+      this->busy = 0;
+      return 0;
+   }
+
+   /* Put the task to sleep and if possible in low power consumption mode.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t sleep() {
+      return 0;
+   }
+
+   /* Awake the task so it runs again.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t wakeup() {
+      return 0;
+   }
+
+};
@@ -0,0 +1,51 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/melodies.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file contains the tunes of the buzzer in the packed melody format of
+ *               melody.hpp. A new tune is added here without changing the buzzer.
+ *               The host tool tools/melody2h converts a MIDI or MusicXML tune into this format.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Tunes can be generated with tools/melody2h.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#include <melody.hpp>
+
+// Win music: Korobeiniki, it was the array of 57 notes of 200 ms in the buzzer.
+const uint8_t WIN_NOTES[] PROGMEM = {
+   // Part A
+   MELODY_NOTE(E, 4), MELODY_SET_OCTAVE(3), MELODY_NOTE(B, 8), MELODY_SET_OCTAVE(4), MELODY_NOTE(C, 8),
+   MELODY_NOTE(D, 4), MELODY_NOTE(C, 8), MELODY_SET_OCTAVE(3), MELODY_NOTE(B, 8),
+   MELODY_NOTE(A, 4), MELODY_NOTE(A, 8), MELODY_SET_OCTAVE(4), MELODY_NOTE(C, 8),
+   MELODY_NOTE(E, 4), MELODY_NOTE(D, 8), MELODY_NOTE(C, 8),
+   MELODY_SET_OCTAVE(3), MELODY_DOTTED_NOTE(B, 4), MELODY_SET_OCTAVE(4), MELODY_NOTE(C, 8),
+   MELODY_NOTE(D, 4), MELODY_NOTE(E, 4),
+   MELODY_NOTE(C, 4), MELODY_SET_OCTAVE(3), MELODY_NOTE(A, 4),
+   MELODY_NOTE(A, 2),
+   // Part B
+   MELODY_SET_OCTAVE(4), MELODY_NOTE(D, 4), MELODY_NOTE(F, 8),
+   MELODY_NOTE(A, 4), MELODY_NOTE(G, 8), MELODY_NOTE(F, 8),
+   MELODY_DOTTED_NOTE(E, 4), MELODY_NOTE(C, 8),
+   MELODY_NOTE(E, 4), MELODY_NOTE(D, 8), MELODY_NOTE(C, 8),
+   MELODY_SET_OCTAVE(3), MELODY_NOTE(B, 4), MELODY_NOTE(B, 8), MELODY_SET_OCTAVE(4), MELODY_NOTE(C, 8),
+   MELODY_NOTE(D, 4), MELODY_NOTE(E, 4),
+   MELODY_NOTE(C, 4), MELODY_SET_OCTAVE(3), MELODY_NOTE(A, 4),
+   MELODY_NOTE(A, 4), MELODY_REST(4),
+};
+const Melody MELODY_WIN = { WIN_NOTES, sizeof(WIN_NOTES), 150, 0 };
@@ -0,0 +1,137 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/melody.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the packed format of the melodies in flash. A note takes one
+ *               byte: the pitch in the low nibble, the duration in bit 4-6 and bit 7 for a dotted
+ *               note. The octave is set with a control byte that is only needed when the octave
+ *               changes, so a note takes one or two bytes. The tempo is stored with the melody.
+ *               The tunes itself are in melodies.hpp. The half periods of all notes in timer1 ticks
+ *               are calculated at compile time, so a note is played without a division.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Table of the half periods of the notes.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#include <waveform.hpp>
+
+// Pitch in the low nibble of a note byte.
+#define NOTE_REST 0
+#define NOTE_C    1
+#define NOTE_CS   2
+#define NOTE_D    3
+#define NOTE_DS   4
+#define NOTE_E    5
+#define NOTE_F    6
+#define NOTE_FS   7
+#define NOTE_G    8
+#define NOTE_GS   9
+#define NOTE_A    10
+#define NOTE_AS   11
+#define NOTE_B    12
+#define NOTE_OCTAVE 15 // Control byte, bit 4-6 is the octave of the next notes
+
+// Duration in bit 4-6 of a note byte, a whole note is shifted right by it.
+#define MELODY_DURATION_1  0
+#define MELODY_DURATION_2  1
+#define MELODY_DURATION_4  2
+#define MELODY_DURATION_8  3
+#define MELODY_DURATION_16 4
+#define MELODY_DURATION_32 5
+
+// Bit 7 of a note byte, the duration is one and a half times longer.
+#define MELODY_DOTTED 0x80
+
+// Octave of the notes when the melody starts.
+#define MELODY_OCTAVE 4
+
+// Write the melodies, for example: MELODY_NOTE(E, 4), MELODY_DOTTED_NOTE(B, 4), MELODY_REST(8), MELODY_SET_OCTAVE(3)
+#define MELODY_NOTE(pitch, duration)        (uint8_t) ((MELODY_DURATION_##duration << 4) | NOTE_##pitch)
+#define MELODY_DOTTED_NOTE(pitch, duration) (uint8_t) (MELODY_DOTTED | MELODY_NOTE(pitch, duration))
+#define MELODY_REST(duration)               MELODY_NOTE(REST, duration)
+#define MELODY_SET_OCTAVE(octave)           (uint8_t) (((octave) << 4) | NOTE_OCTAVE)
+
+/* Struct: Melody
+ * A packed melody in flash.
+ */
+struct Melody {
+   const uint8_t* data; // Packed notes in flash
+   uint16_t length; // Total bytes
+   uint16_t tempo; // Quarter notes per minute
+   uint8_t repeat; // Total times the melody is played, 0 is forever
+};
+
+#define MELODY_OCTAVES 9 // Octave 0-8
+
+// Frequencies in Hz of octave 8, the lower octaves are found by shifting right.
+constexpr uint16_t MELODY_FREQUENCIES[12] PROGMEM = { 4186, 4435, 4699, 4978, 5274, 5588, 5920, 6272, 6645, 7040, 7459, 7902 };
+
+/* Return the frequency of a note.
+ *
+ * @param pitch: NOTE_C - NOTE_B
+ * @param octave: 0-8, octave 4 has the A of 440 Hz
+ * @return The frequency in Hz.
+ */
+inline uint16_t melodyFrequency(uint8_t pitch, uint8_t octave) {
+   return pgm_read_word(&MELODY_FREQUENCIES[pitch - NOTE_C]) >> (8 - octave);
+}
+
+/* Struct: MelodyHalfPeriods
+ * The half periods of all notes, so the table can be generated by a constexpr function.
+ */
+struct MelodyHalfPeriods {
+   uint32_t ticks[MELODY_OCTAVES][12];
+};
+
+/* Generate the half periods of the notes at compile time, from the frequencies of melodyFrequency.
+ *
+ * @param None
+ * @return The half periods.
+ */
+constexpr MelodyHalfPeriods melodyHalfPeriods() {
+   MelodyHalfPeriods h = {};
+   for ( uint8_t octave=0; octave < MELODY_OCTAVES; octave++ ) {
+      for ( uint8_t i=0; i < 12; i++ ) {
+         h.ticks[octave][i] = Waveform::toHalfPeriod(MELODY_FREQUENCIES[i] >> (8 - octave));
+      }
+   }
+   return h;
+}
+
+const MelodyHalfPeriods MELODY_HALF_PERIODS PROGMEM = melodyHalfPeriods();
+
+/* Return the half period of a note.
+ *
+ * @param pitch: NOTE_C - NOTE_B
+ * @param octave: 0-8, octave 4 has the A of 440 Hz
+ * @return The half period in timer1 ticks, see waveform.hpp.
+ */
+inline uint32_t melodyHalfPeriod(uint8_t pitch, uint8_t octave) {
+   return pgm_read_dword(&MELODY_HALF_PERIODS.ticks[octave][pitch - NOTE_C]);
+}
+
+/* Return the duration of a note.
+ *
+ * @param note: the note byte
+ * @param whole: duration in ms of a whole note
+ * @return The duration in ms.
+ */
+inline uint16_t melodyDuration(uint8_t note, uint16_t whole) {
+   uint16_t duration = whole >> ((note >> 4) & 0x07);
+   return (note & MELODY_DOTTED) ? duration + duration / 2 : duration;
+}
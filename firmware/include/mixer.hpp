@@ -0,0 +1,228 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/mixer.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the mixer of the buzzer. Every priority has its own slot with a
+ *               sequencer: the alarm is above the feedback beeps and the feedback beeps are above the
+ *               ticking. Only the highest slot that plays is heard. The lower slots keep their time
+ *               while they are pre-empted, so the ticking is heard on its beat again when a beep ends.
+ *               A new sound only replaces the sound of its own slot.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Every priority has a volume envelope.
+ *               19-10-2026 (MS): The half period of the tone that is heard is read from its table.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#include <sound.hpp>
+
+// Priority of the slots of the mixer, a higher priority pre-empts the lower ones.
+enum SoundPriority : uint8_t {
+   SOUND_PRIORITY_TICKING,
+   SOUND_PRIORITY_FEEDBACK,
+   SOUND_PRIORITY_ALARM,
+   SOUND_PRIORITIES,
+};
+
+// Volume envelope per priority, when the sound has no envelope of its own.
+const Envelope* const MIXER_ENVELOPES[SOUND_PRIORITIES] = { &ENVELOPE_TICKING, &ENVELOPE_FEEDBACK, &ENVELOPE_ALARM };
+
+// Highest slot of a mask of slots that play, SOUND_PRIORITIES when no slot plays.
+const uint8_t MIXER_HIGHEST[1 << SOUND_PRIORITIES] = { SOUND_PRIORITIES, 0, 1, 1, 2, 2, 2, 2 };
+
+/* Class: Mixer
+ * The mixer class selects the sound of the highest priority that plays.
+ */
+class Mixer {
+private:
+   Sequencer slots[SOUND_PRIORITIES]; // Sound per priority
+   uint16_t frequencies[SOUND_PRIORITIES]; // Frequency of the tone per priority, 0 is silent
+   uint32_t halfPeriods[SOUND_PRIORITIES]; // Half period in timer1 ticks of the tone per priority
+   uint8_t playing; // Bit per slot that plays
+   uint8_t highest; // Slot that is heard, SOUND_PRIORITIES when it is silent
+   uint32_t preemptions; // Total times a sound was pre-empted by a higher priority
+   uint32_t resumes; // Total times a pre-empted sound was heard again
+
+   /* Mark a slot as playing and count the pre-emption of the slot that was heard.
+    *
+    * @param priority: the slot
+    * @return None
+    */
+   void start(SoundPriority priority) {
+      this->frequencies[priority] = 0;
+      this->playing |= (1 << priority);
+      this->select();
+   }
+
+   /* Select the slot that is heard.
+    *
+    * @param None
+    * @return None
+    */
+   void select() {
+      uint8_t highest = MIXER_HIGHEST[this->playing];
+      if ( highest != this->highest && this->highest != SOUND_PRIORITIES && highest != SOUND_PRIORITIES ) {
+         if ( highest > this->highest ) {
+            this->preemptions++;
+         } else {
+            this->resumes++;
+         }
+      }
+      this->highest = highest;
+   }
+
+public:
+   Mixer(): frequencies{ 0 }, halfPeriods{ 0 }, playing(0), highest(SOUND_PRIORITIES), preemptions(0), resumes(0) {
+
+   }
+
+   /* Play a sound in the slot of the priority. It replaces the sound of that slot.
+    *
+    * @param priority: the slot
+    * @param sound: the sound
+    * @param millis: current time in ms
+    * @return None
+    */
+   void play(SoundPriority priority, const Sound* sound, uint64_t millis) {
+      this->slots[priority].play(sound, millis);
+      this->start(priority);
+   }
+
+   /* Play a melody in the slot of the priority. It replaces the sound of that slot.
+    *
+    * @param priority: the slot
+    * @param melody: the melody
+    * @param millis: current time in ms
+    * @return None
+    */
+   void play(SoundPriority priority, const Melody* melody, uint64_t millis) {
+      this->slots[priority].play(melody, millis);
+      this->start(priority);
+   }
+
+   /* Stop the sound of a slot.
+    *
+    * @param priority: the slot
+    * @return None
+    */
+   void stop(SoundPriority priority) {
+      this->slots[priority].stop();
+      this->frequencies[priority] = 0;
+      this->playing &= ~(1 << priority);
+      this->select();
+   }
+
+   /* Stop the sounds of all slots.
+    *
+    * @param None
+    * @return None
+    */
+   void stopAll() {
+      for ( uint8_t i=0; i < SOUND_PRIORITIES; i++ ) {
+         this->slots[i].stop();
+         this->frequencies[i] = 0;
+      }
+      this->playing = 0;
+      this->highest = SOUND_PRIORITIES;
+   }
+
+   /* Return whether a slot plays the given sound.
+    *
+    * @param priority: the slot
+    * @param sound: the sound, or NULL for any sound or melody
+    * @return True when it is playing.
+    */
+   bool isPlaying(SoundPriority priority, const Sound* sound = NULL) {
+      return this->slots[priority].isPlaying(sound);
+   }
+
+   /* The loop method plays the tones of every slot, so the pre-empted slots keep their time. The work is
+    * the same for every call: one sequencer per priority and a table lookup for the slot that is heard.
+    *
+    * @param millis: current time in ms
+    * @return The frequency that should be heard, 0 is silent.
+    */
+   uint16_t loop(uint64_t millis) {
+      Tone t;
+      for ( uint8_t i=0; i < SOUND_PRIORITIES; i++ ) {
+         switch ( this->slots[i].loop(millis, &t) ) {
+            case SOUND_TONE:
+               this->frequencies[i] = t.frequency;
+               this->halfPeriods[i] = t.halfPeriod;
+               break;
+            case SOUND_END:
+               this->frequencies[i] = 0;
+               this->playing &= ~(1 << i);
+               break;
+            default:
+               break;
+         }
+      }
+      this->select();
+
+      return this->highest != SOUND_PRIORITIES ? this->frequencies[this->highest] : 0;
+   }
+
+   /* Return the half period of the tone that is heard, it is read from the table of the tone.
+    *
+    * @param None
+    * @return Half period in timer1 ticks, 0 when it is silent.
+    */
+   uint32_t getHalfPeriod() {
+      return this->highest != SOUND_PRIORITIES ? this->halfPeriods[this->highest] : 0;
+   }
+
+   /* Return the volume envelope of the sound that is heard.
+    *
+    * @param None
+    * @return The envelope, NULL when nothing plays.
+    */
+   const Envelope* getEnvelope() {
+      if ( this->highest == SOUND_PRIORITIES ) {
+         return NULL;
+      }
+      const Sound* sound = this->slots[this->highest].getSound();
+      return (sound != NULL && sound->envelope != NULL) ? sound->envelope : MIXER_ENVELOPES[this->highest];
+   }
+
+   /* Return the slot that is heard.
+    *
+    * @param None
+    * @return The priority, SOUND_PRIORITIES when nothing plays.
+    */
+   uint8_t getHighest() {
+      return this->highest;
+   }
+
+   /* Return the total times a sound was pre-empted by a sound with a higher priority.
+    *
+    * @param None
+    * @return Total pre-emptions.
+    */
+   uint32_t getPreemptions() {
+      return this->preemptions;
+   }
+
+   /* Return the total times a pre-empted sound was heard again.
+    *
+    * @param None
+    * @return Total resumes.
+    */
+   uint32_t getResumes() {
+      return this->resumes;
+   }
+};
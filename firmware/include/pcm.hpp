@@ -0,0 +1,227 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/pcm.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the playback of sampled sounds on the buzzer. The samples are
+ *               8 bits unsigned on 8 kHz in flash. The interrupt of timer1 writes one sample every
+ *               125 us to the duty of the sigma-delta modulator on the buzzer pin. The interrupt
+ *               only reads RAM: the loop copies the next block from flash into the free buffer of
+ *               a double buffer, at most one block per loop. The cycles of the interrupt are
+ *               counted, so the load is known as a percentage of the CPU.
+ *               Timer1 is shared with the square wave of waveform.hpp, the buzzer plays either a
+ *               tone or a sample.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#define PCM_RATE      8000 // Samples per second
+#define PCM_TICKS     625 // Timer1 ticks on 5 MHz (TIM_DIV16) per sample
+#define PCM_BLOCK     64 // Samples per buffer, 8 ms on 8 kHz
+#define PCM_CHANNEL   0 // Sigma-delta channel
+#define PCM_CARRIER   312500 // Sigma-delta frequency in Hz, far above the audio
+#define PCM_SILENCE   128 // Sample value of silence
+
+/* Struct: Sample
+ * A sampled sound in flash.
+ */
+struct Sample {
+   const uint8_t* data; // Samples in flash, 8 bits unsigned on 8 kHz
+   uint16_t length; // Total samples
+};
+
+/* Class: PcmPlayer
+ * The PCM player class streams a sample from flash to the sigma-delta modulator. There is only one
+ * timer1, so the state that is shared with the interrupt is static.
+ */
+class PcmPlayer {
+private:
+   inline static volatile uint8_t buffers[2][PCM_BLOCK]; // Double buffer in RAM
+   inline static volatile uint8_t lengths[2] = { 0, 0 }; // Samples in the buffer, 0 when it can be filled
+   inline static volatile uint8_t active = 0; // Buffer that the interrupt reads
+   inline static volatile uint8_t position = 0; // Next sample of the active buffer
+   inline static volatile bool loaded = false; // All samples are copied into the buffers
+   inline static volatile uint32_t samples = 0; // Total samples played
+   inline static volatile uint32_t underruns = 0; // Total samples that were not ready in time
+   inline static volatile uint32_t cycles = 0; // CPU cycles in the interrupt
+   uint8_t pin;
+   const Sample* sample; // Sample that plays, NULL when nothing plays
+   uint16_t index; // Next sample to copy from flash
+   uint64_t start; // Time in ms when the sample started
+   uint64_t end; // Time in ms when the sample stopped
+
+   /* The interrupt of timer1 writes the next sample to the duty of the sigma-delta modulator. When a buffer is
+    * played, it is marked empty and the other buffer is played.
+    *
+    * @param None
+    * @return None
+    */
+   static void IRAM_ATTR isr() {
+      uint32_t begin = ESP.getCycleCount();
+      uint8_t b = PcmPlayer::active;
+      if ( PcmPlayer::position >= PcmPlayer::lengths[b] && PcmPlayer::lengths[b ^ 1] > 0 ) {
+         b ^= 1; // The loop filled the other buffer while this one was empty
+         PcmPlayer::active = b;
+         PcmPlayer::position = 0;
+      }
+
+      if ( PcmPlayer::position < PcmPlayer::lengths[b] ) {
+         GPSD = (GPSD & ~0xFFUL) | PcmPlayer::buffers[b][PcmPlayer::position++];
+         PcmPlayer::samples++;
+         if ( PcmPlayer::position >= PcmPlayer::lengths[b] ) {
+            PcmPlayer::lengths[b] = 0;
+            PcmPlayer::active = b ^ 1;
+            PcmPlayer::position = 0;
+         }
+      } else if ( !PcmPlayer::loaded ) {
+         PcmPlayer::underruns++;
+      }
+      PcmPlayer::cycles += ESP.getCycleCount() - begin;
+   }
+
+   /* Copy the next block of the sample from flash into a buffer.
+    *
+    * @param b: the buffer
+    * @return None
+    */
+   void fill(uint8_t b) {
+      uint16_t n = this->sample->length - this->index;
+      n = (n > PCM_BLOCK ? PCM_BLOCK : n);
+      memcpy_P((void*) PcmPlayer::buffers[b], &this->sample->data[this->index], n);
+      this->index += n;
+      PcmPlayer::lengths[b] = n; // Written last, the interrupt reads the buffer from now on
+      if ( this->index >= this->sample->length ) {
+         PcmPlayer::loaded = true;
+      }
+   }
+
+public:
+   PcmPlayer(uint8_t pin = D8): pin(pin), sample(NULL), index(0), start(0), end(0) {
+
+   }
+
+   /* Start to play a sample. Both buffers are filled before the interrupt starts.
+    *
+    * @param sample: the sample
+    * @param millis: current time in ms
+    * @return None
+    */
+   void play(const Sample* sample, uint64_t millis) {
+      timer1_disable();
+      this->sample = sample;
+      this->index = 0;
+      this->start = millis;
+      PcmPlayer::active = 0;
+      PcmPlayer::position = 0;
+      PcmPlayer::loaded = false;
+      PcmPlayer::lengths[0] = 0;
+      PcmPlayer::lengths[1] = 0;
+      PcmPlayer::samples = 0;
+      PcmPlayer::underruns = 0;
+      PcmPlayer::cycles = 0;
+      this->fill(0);
+      if ( !PcmPlayer::loaded ) {
+         this->fill(1);
+      }
+
+      sigmaDeltaSetup(PCM_CHANNEL, PCM_CARRIER);
+      GPSD = (GPSD & ~0xFFUL) | PCM_SILENCE;
+      sigmaDeltaAttachPin(this->pin, PCM_CHANNEL);
+      timer1_attachInterrupt(PcmPlayer::isr);
+      timer1_enable(TIM_DIV16, TIM_EDGE, TIM_LOOP);
+      timer1_write(PCM_TICKS);
+   }
+
+   /* Stop the sample and release timer1 and the pin.
+    *
+    * @param None
+    * @return None
+    */
+   void stop() {
+      if ( this->sample == NULL ) {
+         return;
+      }
+      timer1_disable();
+      sigmaDeltaDetachPin(this->pin);
+      pinMode(this->pin, OUTPUT);
+      digitalWrite(this->pin, LOW);
+      this->sample = NULL;
+      this->end = millis();
+   }
+
+   /* The loop method copies the next block into a buffer that the interrupt has played. It copies at most one
+    * block, so the time of a loop is bounded. The sample stops when all samples are played.
+    *
+    * @param None
+    * @return None
+    */
+   void loop() {
+      if ( this->sample == NULL ) {
+         return;
+      }
+
+      if ( PcmPlayer::loaded ) {
+         if ( PcmPlayer::lengths[0] == 0 && PcmPlayer::lengths[1] == 0 ) {
+            this->stop();
+         }
+         return;
+      }
+
+      // The buffer that is not played. After an underrun the interrupt switches to it as soon as it is filled.
+      uint8_t free = PcmPlayer::active ^ 1;
+      if ( PcmPlayer::lengths[free] == 0 ) {
+         this->fill(free);
+      }
+   }
+
+   /* Return whether a sample plays.
+    *
+    * @param None
+    * @return True when it plays.
+    */
+   bool isPlaying() {
+      return this->sample != NULL;
+   }
+
+   /* Return the total samples that are played of the last sample.
+    *
+    * @param None
+    * @return Total samples.
+    */
+   uint32_t getSamples() {
+      return PcmPlayer::samples;
+   }
+
+   /* Return the total samples of the last sample that were not ready in time.
+    *
+    * @param None
+    * @return Total underruns.
+    */
+   uint32_t getUnderruns() {
+      return PcmPlayer::underruns;
+   }
+
+   /* Return the load of the interrupt as part of the CPU time while the last sample played.
+    *
+    * @param millis: current time in ms
+    * @return Load in hundredths of a percent.
+    */
+   uint32_t getLoad(uint64_t millis) {
+      uint64_t elapsed = ((this->sample != NULL ? millis : this->end) - this->start) * 1000 * ESP.getCpuFreqMHz();
+      return elapsed > 0 ? (uint32_t) ((uint64_t) PcmPlayer::cycles * 10000 / elapsed) : 0;
+   }
+};
@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/puzzle.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the generator of the puzzles. A puzzle is created from a 32 bits seed
+ *               with its own random generator (xorshift32), so the same seed gives the same puzzle on every
+ *               device and version of the core. The seed of a new game comes from the hardware random
+ *               generator of the ESP8266. The teacher can replay a puzzle with its seed, which is shown as
+ *               eight hex characters. The order is shuffled with Fisher-Yates, one random number per
+ *               element, so the time does not depend on luck.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+/* Class: Puzzle
+ * The puzzle class creates the random numbers of a puzzle from a seed.
+ */
+class Puzzle {
+private:
+   uint32_t state; // State of the xorshift32 generator, never 0
+   uint32_t draws; // Total random numbers that are generated
+
+public:
+   Puzzle(uint32_t seed): state(seed != 0 ? seed : 1), draws(0) {
+
+   }
+
+   /* Return a seed from the hardware random generator, it is never 0.
+    *
+    * @param None
+    * @return The seed.
+    */
+   static uint32_t hardwareSeed() {
+      uint32_t seed = ESP.random();
+      return seed != 0 ? seed : 1;
+   }
+
+   /* Return the next random number of the xorshift32 generator.
+    *
+    * @param None
+    * @return The random number.
+    */
+   uint32_t next() {
+      this->draws++;
+      this->state ^= this->state << 13;
+      this->state ^= this->state >> 17;
+      this->state ^= this->state << 5;
+      return this->state;
+   }
+
+   /* Return a random number below a maximum. It multiplies instead of a modulo and it does not retry, so it takes
+    * one random number. The bias is at most max / 2^32.
+    *
+    * @param max: the maximum, not included
+    * @return The random number, 0 to max - 1.
+    */
+   uint32_t below(uint32_t max) {
+      return (uint32_t) (((uint64_t) this->next() * max) >> 32);
+   }
+
+   /* Shuffle the elements with Fisher-Yates, every order has the same chance.
+    *
+    * @param values: the elements
+    * @param total: total elements
+    * @return None
+    */
+   void shuffle(uint8_t* values, uint8_t total) {
+      for ( uint8_t i=total; i > 1; i-- ) {
+         uint8_t j = this->below(i);
+         uint8_t value = values[i - 1];
+         values[i - 1] = values[j];
+         values[j] = value;
+      }
+   }
+
+   /* Return the total random numbers that are generated.
+    *
+    * @param None
+    * @return Total random numbers.
+    */
+   uint32_t getDraws() {
+      return this->draws;
+   }
+};
@@ -0,0 +1,60 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/samples.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file contains the sampled sounds of pcm.hpp, 8 bits unsigned on 8 kHz in flash.
+ *               The explosion is generated at compile time: noise of a 16 bits LFSR through a low
+ *               pass filter with a volume that decays to silence. A recorded sound, like a voice
+ *               line, is added as a table of bytes.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#include <pcm.hpp>
+
+#define SAMPLE_EXPLOSION_LENGTH 4000 // 0.5 s on 8 kHz
+
+/* Struct: SampleExplosion
+ * The samples of the explosion, so the table can be generated by a constexpr function.
+ */
+struct SampleExplosion {
+   uint8_t data[SAMPLE_EXPLOSION_LENGTH];
+};
+
+/* Generate the explosion at compile time.
+ *
+ * @param None
+ * @return The samples.
+ */
+constexpr SampleExplosion sampleExplosion() {
+   SampleExplosion s = {};
+   uint16_t lfsr = 0xACE1;
+   int32_t filtered = 0;
+   for ( uint16_t i=0; i < SAMPLE_EXPLOSION_LENGTH; i++ ) {
+      lfsr = (lfsr >> 1) ^ (-(lfsr & 1) & 0xB400);
+      int32_t noise = (int32_t) (lfsr & 0xFF) - 128;
+      filtered += (noise - filtered) / 4; // Low pass, the rumble of the explosion
+      int32_t volume = SAMPLE_EXPLOSION_LENGTH - i; // Linear decay to silence
+      int32_t value = PCM_SILENCE + filtered * 2 * volume / SAMPLE_EXPLOSION_LENGTH;
+      s.data[i] = (uint8_t) (value < 0 ? 0 : (value > 255 ? 255 : value)); // Clipped, it does not wrap around
+   }
+   return s;
+}
+
+const SampleExplosion EXPLOSION_DATA PROGMEM = sampleExplosion();
+const Sample SAMPLE_EXPLOSION = { EXPLOSION_DATA.data, SAMPLE_EXPLOSION_LENGTH };
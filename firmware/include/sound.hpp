@@ -0,0 +1,293 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/sound.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the sound effects of the buzzer. A sound is a sequence of
+ *               tones (frequency, duration and half period) in flash. The sequencer is called from the loop
+ *               and only reads the next tone when its deadline has passed, so a sound never
+ *               blocks the loop. The sequencer also plays the packed melodies of melody.hpp.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Play packed melodies, the win music is a melody now.
+ *               19-10-2026 (MS): A sound can have its own volume envelope.
+ *               19-10-2026 (MS): The tones store their half period in timer1 ticks.
+ *               19-10-2026 (MS): A tone is played at least 1 ms.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#include <melody.hpp>
+#include <envelope.hpp>
+#include <waveform.hpp>
+
+// Enumeration for notes to use music
+enum Notes : uint32_t { // Octave 3 - https://forum.professionalcomposers.com/t/note-frequency-chart-free-guide/506
+   C  = 131,
+   CS = 139,
+   D  = 147,
+   DS = 156,
+   E  = 165,
+   F  = 175,
+   FS = 185,
+   G  = 196,
+   GS = 208,
+   A  = 220,
+   AS = 233,
+   B  = 247,
+};
+
+// Result of the sequencer loop.
+enum SoundStatus {
+   SOUND_IDLE, // Nothing to do
+   SOUND_TONE, // A new tone should be played
+   SOUND_END,  // The sound is finished
+};
+
+/* Struct: Tone
+ * One step of a sound that is played for the given duration.
+ */
+struct Tone {
+   uint16_t frequency; // Frequency in Hz, 0 is silent
+   uint16_t duration; // Time in ms that the tone is played
+   uint32_t halfPeriod; // Half period in timer1 ticks, 0 is silent
+};
+
+// Write the tones, the half period is calculated at compile time, for example: TONE(1000, 5), TONE(0, 5)
+#define TONE(frequency, duration) { (uint16_t) (frequency), (uint16_t) (duration), Waveform::toHalfPeriod(frequency) }
+
+/* Struct: Sound
+ * A sequence of tones in flash.
+ */
+struct Sound {
+   const Tone* tones; // Tones in flash
+   uint8_t count; // Total tones
+   uint8_t repeat; // Total times the sequence is played, 0 is forever
+   const Envelope* envelope; // Volume envelope of the tones, NULL for the envelope of the priority
+};
+
+// Short beep, for example when the button is pressed.
+const Tone BEEP_TONES[] PROGMEM = { TONE(1000, 5), TONE(0, 5) };
+const Sound SOUND_BEEP = { BEEP_TONES, 2, 1, &ENVELOPE_BEEP };
+
+// The two ticks of the ticking bomb.
+const Tone TICK_A_TONES[] PROGMEM = { TONE(100, 5), TONE(0, 5) };
+const Sound SOUND_TICK_A = { TICK_A_TONES, 2, 1, NULL };
+const Tone TICK_B_TONES[] PROGMEM = { TONE(200, 5), TONE(0, 5) };
+const Sound SOUND_TICK_B = { TICK_B_TONES, 2, 1, NULL };
+
+// Feedback when a wire is cut.
+const Tone CORRECT_TONES[] PROGMEM = { TONE(4000, 100), TONE(0, 100) };
+const Sound SOUND_CORRECT = { CORRECT_TONES, 2, 1, NULL };
+const Tone NOT_CORRECT_TONES[] PROGMEM = { TONE(500, 100), TONE(0, 100) };
+const Sound SOUND_NOT_CORRECT = { NOT_CORRECT_TONES, 2, 1, NULL };
+
+// Alarm when the bomb explodes, a fast scale that repeats until it is muted.
+const Tone LOSE_TONES[] PROGMEM = { TONE(C, 5), TONE(0, 5), TONE(D, 5), TONE(0, 5), TONE(E, 5), TONE(0, 5),
+                                    TONE(F, 5), TONE(0, 5), TONE(G, 5), TONE(0, 5), TONE(A, 5), TONE(0, 5),
+                                    TONE(B, 5), TONE(0, 5) };
+const Sound SOUND_LOSE = { LOSE_TONES, 14, 0, NULL };
+
+/* Class: Sequencer
+ * The sequencer class plays a sound or a packed melody with a deadline per tone.
+ */
+class Sequencer {
+private:
+   const Sound* sound; // Sound that is playing, NULL when nothing or a melody is playing
+   const Melody* melody; // Melody that is playing, NULL when nothing or a sound is playing
+   uint16_t index; // Next tone of the sound or next byte of the melody
+   uint8_t played; // Total times the sequence has been played
+   uint8_t octave; // Octave of the next notes of the melody
+   uint16_t whole; // Duration in ms of a whole note of the melody
+   uint16_t gap; // Silence in ms after the note that is played, so repeated notes are heard
+   uint64_t deadline; // Time in ms when the next tone should be played
+
+   /* Start the sequence from the beginning.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void start(uint64_t millis) {
+      this->index = 0;
+      this->played = 0;
+      this->octave = MELODY_OCTAVE;
+      this->gap = 0;
+      this->deadline = millis;
+   }
+
+   /* Read the next tone of the sequence. A note of a melody is followed by a short gap of an eighth of
+    * its duration.
+    *
+    * @param tone: the next tone
+    * @return True when there is a next tone, false at the end of the sequence.
+    */
+   bool read(Tone* tone) {
+      if ( this->sound != NULL ) {
+         if ( this->index >= this->sound->count ) {
+            return false;
+         }
+         memcpy_P(tone, &this->sound->tones[this->index++], sizeof(Tone));
+         return true;
+      }
+
+      if ( this->gap > 0 ) {
+         *tone = { 0, this->gap, 0 };
+         this->gap = 0;
+         return true;
+      }
+
+      while ( this->index < this->melody->length ) {
+         uint8_t note = pgm_read_byte(&this->melody->data[this->index++]);
+         uint8_t pitch = note & 0x0F;
+         if ( pitch == NOTE_OCTAVE ) {
+            this->octave = (note >> 4) & 0x07;
+            continue;
+         }
+
+         uint16_t duration = melodyDuration(note, this->whole);
+         if ( pitch == NOTE_REST || pitch > NOTE_B ) {
+            *tone = { 0, duration, 0 };
+         } else {
+            this->gap = duration / 8;
+            *tone = { melodyFrequency(pitch, this->octave), (uint16_t) (duration - this->gap),
+                      melodyHalfPeriod(pitch, this->octave) };
+         }
+         return true;
+      }
+      return false;
+   }
+
+   /* Return the next tone of the sequence with a duration of at least 1 ms, like Buzzer::beep. A sound that
+    * repeats forever with only tones of 0 ms would otherwise never pass the time of the loop.
+    *
+    * @param tone: the next tone
+    * @return True when there is a next tone, false at the end of the sequence.
+    */
+   bool next(Tone* tone) {
+      if ( !this->read(tone) ) {
+         return false;
+      }
+      if ( tone->duration == 0 ) {
+         tone->duration = 1;
+      }
+      return true;
+   }
+
+public:
+   Sequencer(): sound(NULL), melody(NULL), index(0), played(0), octave(MELODY_OCTAVE), whole(0), gap(0),
+                deadline(0) {
+
+   }
+
+   /* Start to play a sound from the first tone.
+    *
+    * @param sound: the sound to play
+    * @param millis: current time in ms
+    * @return None
+    */
+   void play(const Sound* sound, uint64_t millis) {
+      this->sound = sound;
+      this->melody = NULL;
+      this->start(millis);
+   }
+
+   /* Start to play a melody from the first note.
+    *
+    * @param melody: the melody to play
+    * @param millis: current time in ms
+    * @return None
+    */
+   void play(const Melody* melody, uint64_t millis) {
+      this->sound = NULL;
+      this->melody = melody;
+      this->whole = 240000UL / melody->tempo; // Four quarter notes
+      this->start(millis);
+   }
+
+   /* Stop the sound or melody.
+    *
+    * @param None
+    * @return None
+    */
+   void stop() {
+      this->sound = NULL;
+      this->melody = NULL;
+   }
+
+   /* Return whether the given sound is playing.
+    *
+    * @param sound: the sound, or NULL for any sound or melody
+    * @return True when it is playing.
+    */
+   bool isPlaying(const Sound* sound = NULL) {
+      if ( sound == NULL ) {
+         return this->sound != NULL || this->melody != NULL;
+      }
+      return this->sound == sound;
+   }
+
+   /* Return the sound that is playing.
+    *
+    * @param None
+    * @return The sound, NULL when nothing or a melody is playing.
+    */
+   const Sound* getSound() {
+      return this->sound;
+   }
+
+   /* Return whether the given melody is playing.
+    *
+    * @param melody: the melody
+    * @return True when it is playing.
+    */
+   bool isPlaying(const Melody* melody) {
+      return this->melody != NULL && this->melody == melody;
+   }
+
+   /* The loop method checks the deadline of the next tone. The deadlines are calculated from the previous
+    * deadline, so the sound does not drift. When the loop was late, the missed tones are skipped.
+    *
+    * @param millis: current time in ms
+    * @param tone: the tone that should be played when SOUND_TONE is returned
+    * @return The status of the sound.
+    */
+   SoundStatus loop(uint64_t millis, Tone* tone) {
+      if ( !this->isPlaying() || millis < this->deadline ) {
+         return SOUND_IDLE;
+      }
+
+      Tone t;
+      do {
+         if ( !this->next(&t) ) {
+            this->played++;
+            uint8_t repeat = (this->sound != NULL ? this->sound->repeat : this->melody->repeat);
+            if ( repeat != 0 && this->played >= repeat ) {
+               this->stop();
+               return SOUND_END;
+            }
+            this->index = 0;
+            this->octave = MELODY_OCTAVE;
+            if ( !this->next(&t) ) { // Empty sequence
+               this->stop();
+               return SOUND_END;
+            }
+         }
+         this->deadline += t.duration;
+      } while ( millis >= this->deadline );
+
+      *tone = t;
+      return SOUND_TONE;
+   }
+};
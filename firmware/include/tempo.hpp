@@ -0,0 +1,196 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/tempo.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the tempo of the ticking bomb. The tick interval follows a curve
+ *               in flash over the time that is left on the countdown, so the ticking speeds up
+ *               smoothly toward zero. Every mistake halves the interval. The curve has a fixed time
+ *               per step and the step is found by walking down from the previous step, so the loop
+ *               does not divide and does not use floating point. Every game has its own curve.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <driver.h>
+#include <Arduino.h>
+
+#include <timer.hpp>
+#include <buzzer.hpp>
+
+// Tick interval in ms per step of the curve, from zero time left to the start of the curve.
+// The interval is 150 + 450 * (step / 31)^2 ms, so the speed up is the largest near zero.
+const uint16_t TEMPO_INTERVALS[32] PROGMEM = {
+   150, 150, 152, 154, 157, 162, 167, 173, 180, 188, 197, 207, 217, 229, 242, 255,
+   270, 285, 302, 319, 337, 357, 377, 398, 420, 443, 467, 491, 517, 544, 571, 600,
+};
+
+/* Struct: TempoCurve
+ * The tempo of the ticking during a game.
+ */
+struct TempoCurve {
+   const uint16_t* intervals; // Tick interval in ms per step in flash, the first step is at zero time left
+   uint8_t length; // Total steps, the last step is used before the curve starts
+   uint16_t step; // Seconds per step
+   uint16_t minimum; // Shortest tick interval in ms when mistakes are made
+   uint8_t mistakes; // Most mistakes that halve the interval
+};
+
+// Game 1: the curve covers the last 10:40 of the countdown, a wrong wire doubles the speed.
+const TempoCurve TEMPO_GAME_1 = { TEMPO_INTERVALS, 32, 20, 75, 1 };
+
+// Game 2: the curve covers the last 5:20 of the countdown, every wrong code makes it faster.
+const TempoCurve TEMPO_GAME_2 = { TEMPO_INTERVALS, 32, 10, 75, 2 };
+
+/* Class: Tempo
+ * The tempo class sets the tick interval of the buzzer from the time that is left on the timer.
+ */
+class Tempo: public IDriver {
+private:
+   Timer* timer;
+   Buzzer* buzzer;
+   const TempoCurve* curve; // Curve of the game, NULL when the tempo is stopped
+   uint8_t index; // Step of the curve
+   uint32_t boundary; // Seconds left where the step starts
+   uint32_t left; // Seconds left on the previous update
+   uint8_t mistakes; // Total mistakes of the player
+   uint16_t interval; // Tick interval in ms that is set on the buzzer
+   bool changed; // The mistakes changed since the previous update
+
+public:
+   Tempo(Timer* timer, Buzzer* buzzer): timer(timer), buzzer(buzzer), curve(NULL), index(0), boundary(0), left(0),
+                                        mistakes(0), interval(0), changed(false) {
+
+   }
+
+   /* The setup method initializes the task. This method should be called once at the startup of the board.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t setup() {
+      this->stop();
+      return 0;
+   }
+
+   /* The loop method updates the tick interval when the seconds left or the mistakes changed. The step of the
+    * curve only walks down, because the time left only decreases during a game.
+    *
+    * @param millis: current time in ms
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t loop(uint64_t) {
+      if ( this->curve == NULL ) {
+         return 0;
+      }
+
+      uint32_t left = this->timer->getMinutes() * 60 + this->timer->getSeconds();
+      if ( left == this->left && !this->changed ) {
+         return 0;
+      }
+      this->left = left;
+      this->changed = false;
+
+      while ( this->index > 0 && left < this->boundary ) {
+         this->index--;
+         this->boundary -= this->curve->step;
+      }
+
+      uint8_t shift = (this->mistakes < this->curve->mistakes ? this->mistakes : this->curve->mistakes);
+      uint16_t interval = pgm_read_word(&this->curve->intervals[this->index]) >> shift;
+      if ( interval < this->curve->minimum ) {
+         interval = this->curve->minimum;
+      }
+      if ( interval != this->interval ) {
+         this->interval = interval;
+         this->buzzer->setTickInterval(interval);
+      }
+
+      return 0;
+   }
+
+   /* Start the tempo of a game. The interval is set on the next loop.
+    *
+    * @param curve: the curve of the game
+    * @return None
+    */
+   void start(const TempoCurve* curve) {
+      this->curve = curve;
+      this->index = curve->length - 1;
+      this->boundary = (uint32_t) this->index * curve->step;
+      this->mistakes = 0;
+      this->interval = 0;
+      this->changed = true;
+   }
+
+   /* Stop the tempo, the buzzer keeps the last interval.
+    *
+    * @param None
+    * @return None
+    */
+   void stop() {
+      this->curve = NULL;
+   }
+
+   /* Set the total mistakes of the player.
+    *
+    * @param mistakes: total mistakes
+    * @return None
+    */
+   void setMistakes(uint8_t mistakes) {
+      if ( mistakes != this->mistakes ) {
+         this->mistakes = mistakes;
+         this->changed = true;
+      }
+   }
+
+   /* Return the tick interval that is set on the buzzer.
+    *
+    * @param None
+    * @return Interval in ms, 0 before the first update.
+    */
+   uint16_t getInterval() {
+      return this->interval;
+   }
+
+   /* The abstract reset function resets the task. If successfull the method returns 0, otherwise it returns an error
+       number.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t reset() {
+      this->stop();
+      return 0;
+   }
+
+   /* Put the task to sleep and if possible in low power consumption mode.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t sleep() {
+      return 0;
+   }
+
+   /* Awake the task so it runs again.
+    *
+    * @param None
+    * @return Zero is successfull and non-zero when an error occurred.
+    */
+   uint8_t wakeup() {
+      return 0;
+   }
+};
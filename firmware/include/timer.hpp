@@ -20,11 +20,24 @@
  * @updates    : 20-02-2024 (MS): Initial code.
  *               16-06-2024 (MS): Created the first release version.
  *               27-03-2026 (MS): Improved code and documentation.
+ *               19-10-2026 (MS): Added getters for the native tests.
+ *               19-10-2026 (MS): Countdown is calculated from the start time, so it does not drift.
+ *               19-10-2026 (MS): Draw in the framebuffer of the display instead of the HT16K33 directly.
+ *               19-10-2026 (MS): Display writes are enqueued in the I2C queue.
+ *               19-10-2026 (MS): Texts are rendered with the 7-segments font, added showText with scrolling.
+ *               19-10-2026 (MS): Added keyframe animations: spinner, last minute flash and win/lose fanfare.
+ *               19-10-2026 (MS): Show the tenths of seconds in the last minute.
+ *               19-10-2026 (MS): The display is one of the displays of the display manager.
  * @todo       : 
  */
 #include <driver.h>
 
-#include <HT16K33.h>
+#include <displaymanager.hpp>
+#include <font.hpp>
+#include <animation.hpp>
+
+// Time in ms that a scrolling text shows each position.
+#define TIMER_SCROLL_MS 300
 
 // Timer state to implement specific function when this is selected.
 enum TimerState {
@@ -39,17 +52,64 @@ enum TimerState {
  */
 class Timer: public IDriver {
 private:
-   uint64_t timer; // Timer that is used for timing purposes
+   uint64_t timer; // Start of the countdown, all second deadlines are calculated from this fixed point
+   uint32_t ticks; // Total seconds that have been counted down since the start
+   uint32_t tenths; // Total tenths of seconds that have been counted down since the start, in the last minute
+   bool highResolution; // Show the tenths of seconds in the last minute
+   int32_t endError; // Difference between the measured and planned end of the countdown in ms
    uint8_t state; // State is used to determine which functionality needs to be executed
-   HT16K33 seg; // The library that handles the hardware based on the chip HT16K33
+   Display* display; // Framebuffer of the display, the display manager writes the changes to the HT16K33
    uint32_t totalMinutes; // Total minutes that will be default selected
    uint32_t minutes; // Total minutes left
    uint32_t seconds; // Total seconds left
    bool dash; // Show the dash or not
-   
+   const char* scrollText; // Text that is scrolling over the display, NULL when no text is scrolling
+   uint8_t scrollPos; // Position of the text that is shown on the first digit
+   uint64_t scrollTimer; // Deadline of the previous scroll step
+   Animator animator; // Player of the keyframe animations
+
+   /* Stop a scrolling text and a playing animation.
+    *  
+    * @param None
+    * @return None
+    */
+   void stopEffects() {
+      this->scrollText = NULL;
+      this->animator.stop();
+      this->display->setVisible(DISPLAY_ALL);
+   }
+
+   /* Draw the given digits on the display and stop a scrolling text or animation.
+    *  
+    * @param digits: segments of the four digits
+    * @param colon: show the colon
+    * @return None
+    */
+   void draw(const uint8_t digits[4], bool colon) {
+      this->stopEffects();
+      this->display->setRaw(digits, colon);
+   }
+
+   /* Show a keyframe of an animation. A mask keyframe hides positions of the frame, otherwise the
+    * keyframe replaces the frame.
+    *  
+    * @param k: the keyframe
+    * @return None
+    */
+   void showKeyframe(const Keyframe &k) {
+      if ( k.flags & KEYFRAME_MASK ) {
+         uint8_t mask = (k.text.digits[0] ? 0x01 : 0) | (k.text.digits[1] ? 0x02 : 0) |
+                        (k.flags & KEYFRAME_COLON ? 0x04 : 0) |
+                        (k.text.digits[2] ? 0x08 : 0) | (k.text.digits[3] ? 0x10 : 0);
+         this->display->setVisible(mask);
+      } else {
+         this->display->setRaw(k.text.digits, k.flags & KEYFRAME_COLON);
+      }
+   }
 
 public:
-   Timer(): timer(0), state(START), seg(0x70), totalMinutes(30), minutes(0), seconds(0), dash(true) {
+   Timer(Display* display): timer(0), ticks(0), tenths(0), highResolution(true), endError(0), state(START), display(display), totalMinutes(30), minutes(0),
+                         seconds(0), dash(true), scrollText(NULL), scrollPos(0), scrollTimer(0) {
 
    }
 
@@ -65,16 +125,6 @@ public:
     * @return Zero is successfull and non-zero when an error occurred.
     */
    uint8_t setup() {
-      // Setup the I2C library to connect to the 7-segments display on 400kHz.
-      Wire.begin();
-      Wire.setClock(400000);
-   
-      // Setup the HT16K33 library to connect with the display.
-      seg.begin();
-      seg.displayOn();
-      seg.setBrightness(4);
-      seg.setDigits(4);
-
       // Initially show the dashes on the display.
       this->showDashes();
 
@@ -93,24 +143,72 @@ public:
     */
    uint8_t loop(uint64_t millis) {
       if ( this->state == COUNTDOWN ) {
-         if ( millis - this->timer > 1000 ) {
-            if (this->seconds == 0 ) {
-               if ( this->minutes == 0 ) {
-                  this->state = FINISH;
-                  this->showLose();
-               } else {
-                  this->minutes--;
-                  this->seconds = 59;
-               }
-            } else {
-               this->seconds--;
+         // The deadline of the next second is calculated from the start, so loop latency does not add up. When
+         // the loop has been stalled for more than a second, the missed seconds are caught up at once.
+         uint32_t total = this->totalMinutes * 60;
+         uint32_t ticks = this->ticks;
+         while ( ticks < total && millis - this->timer >= (uint64_t) (ticks + 1) * 1000 ) {
+            ticks++;
+         }
+
+         bool changed = ( ticks != this->ticks );
+         if ( changed ) {
+            this->ticks = ticks;
+            this->minutes = (total - ticks) / 60;
+            this->seconds = (total - ticks) % 60;
+            this->dash = (ticks % 2 == 0);
+
+            // Flash the countdown in the last minute, aligned with the seconds.
+            if ( total - ticks <= 60 && !this->animator.isPlaying(&ANIMATION_FLASH) ) {
+               this->animator.play(&ANIMATION_FLASH, this->timer + (uint64_t) ticks * 1000);
             }
-            this->timer = millis;
-            this->dash = !this->dash;
-            seg.displayTime(this->minutes, this->seconds, this->dash, true);
+         }
+
+         if ( this->highResolution && ticks < total && total - ticks <= 60 ) {
+            // Below one minute the tenths are shown, with deadlines of 100 ms from the start as well. They are
+            // calculated at once, counting them up would take all tenths of the game in the first pass.
+            uint32_t tenths = (uint32_t) ((millis - this->timer) / 100);
+            uint32_t left = total * 10 - tenths;
+            if ( left < 600 && (tenths != this->tenths || changed) ) {
+               this->display->setTenths(left);
+            } else if ( changed ) {
+               this->display->setTime(this->minutes, this->seconds, this->dash);
+            }
+            this->tenths = tenths;
+
+         } else if ( changed ) {
+            this->display->setTime(this->minutes, this->seconds, this->dash);
+         }
+
+         if ( changed && ticks == total ) {
+            this->stopEffects();
+            this->endError = (int32_t) (millis - (this->timer + (uint64_t) total * 1000));
+            this->state = FINISH;
+            printf("Countdown finished with an error of %d ms\n", (int) this->endError);
          }
       }
-      
+
+      // Scroll the text one position further, the deadlines are calculated from the start of the text.
+      if ( this->scrollText != NULL && millis - this->scrollTimer >= TIMER_SCROLL_MS ) {
+         this->scrollTimer += TIMER_SCROLL_MS;
+         this->scrollPos = (this->scrollPos + 1) % (fontLength(this->scrollText) + 1);
+         FontText t = fontRender(fontSkip(this->scrollText, this->scrollPos));
+         this->display->setRaw(t.digits, false);
+      }
+
+      // Show the next keyframe of the animation when its deadline has passed.
+      Keyframe k;
+      switch ( this->animator.loop(millis, &k) ) {
+         case ANIMATION_FRAME:
+            this->showKeyframe(k);
+            break;
+         case ANIMATION_END:
+            this->display->setVisible(DISPLAY_ALL);
+            break;
+         default:
+            break;
+      }
+
       return 0;
    }
 
@@ -123,17 +221,52 @@ public:
       return this->minutes == 0 && this->seconds == 0;
    }
 
+   /* Return the minutes that are left on the countdown.
+    *  
+    * @param None
+    * @return Minutes left.
+    */
+   uint32_t getMinutes () {
+      return this->minutes;
+   }
+
+   /* Return the seconds that are left on the countdown within the current minute.
+    *  
+    * @param None
+    * @return Seconds left (0-59).
+    */
+   uint32_t getSeconds () {
+      return this->seconds;
+   }
+
+   /* Return the measured error of the end of the last countdown compared to the planned end. It is the time
+    * that the loop was too late to detect the last second.
+    *  
+    * @param None
+    * @return Error in ms.
+    */
+   int32_t getEndError () {
+      return this->endError;
+   }
+
+   /* Return the framebuffer of the display, for example to read the I2C statistics.
+    *  
+    * @param None
+    * @return Pointer to the display.
+    */
+   Display* getDisplay () {
+      return this->display;
+   }
+
    /* Show LOSE on the display.
     *  
     * @param None
     * @return None
     */
    void showLose() {
-      uint8_t x[4] = { SEG_D | SEG_E | SEG_F,
-                       SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F,
-                       SEG_A | SEG_C | SEG_D | SEG_F | SEG_G,
-                       SEG_A | SEG_D | SEG_E | SEG_F | SEG_G };
-      seg.displayRaw(x, false);
+      constexpr FontText text = fontText("LOSE");
+      this->draw(text.digits, false);
+      this->animator.play(&ANIMATION_LOSE, millis());
       this->state = FINISH;
    }
 
@@ -143,11 +276,9 @@ public:
     * @return None
     */
    void showYeah() {
-      uint8_t x[4] = { SEG_B | SEG_C | SEG_D | SEG_F| SEG_G,
-                       SEG_A | SEG_D | SEG_E | SEG_F | SEG_G,
-                       SEG_A | SEG_B | SEG_C | SEG_E | SEG_F | SEG_G,
-                       SEG_B | SEG_C | SEG_E | SEG_F | SEG_G };
-      seg.displayRaw(x, false);
+      constexpr FontText text = fontText("YEAH");
+      this->draw(text.digits, false);
+      this->animator.play(&ANIMATION_WIN, millis());
       this->state = FINISH;
    }
 
@@ -157,18 +288,56 @@ public:
     * @return None
     */
    void showDashes() {
-      uint8_t x[4] = { SEG_G, SEG_G, SEG_G, SEG_G };
-      seg.displayRaw(x, true);
+      constexpr FontText text = fontText("----");
+      this->draw(text.digits, true);
       this->state = START;
    }
 
+   /* Show a text on the display. A text longer than four positions scrolls from right to left. A
+    * dot is shown as decimal point of the character before it. The text is not copied, so it
+    * should stay valid while it is shown, like a string literal.
+    *  
+    * @param text: the text to show
+    * @return None
+    */
+   void showText(const char* text) {
+      FontText t = fontRender(text);
+      this->draw(t.digits, false);
+
+      if ( fontLength(text) > 4 ) {
+         this->scrollText = text;
+         this->scrollPos = 0;
+         this->scrollTimer = millis();
+      }
+   }
+
+   /* Enable or disable the tenths of seconds (SS.t) in the last minute of the countdown.
+    *  
+    * @param on: true to show the tenths
+    * @return None
+    */
+   void setHighResolution(bool on) {
+      this->highResolution = on;
+   }
+
+   /* Show the spinner animation until something else is shown.
+    *  
+    * @param None
+    * @return None
+    */
+   void showSpinner() {
+      constexpr FontText text = fontText("    ");
+      this->draw(text.digits, false);
+      this->animator.play(&ANIMATION_SPINNER, millis());
+   }
+
    /* Blink the display.
     *  
     * @param None
     * @return None
     */
    void blink(bool on) {
-      this->seg.setBlink( (on ? 2 : 0) );
+      this->display->setBlink( (on ? 2 : 0) );
    }
 
    /* Show the time on the display.
@@ -186,15 +355,21 @@ public:
          seconds = 59;
       }
 
-      this->seg.displayTime(minutes, seconds, true, true); // Show colon and leading zero
+      this->stopEffects();
+      this->display->setTime(minutes, seconds, true); // Show colon and leading zero
 
       this->state = START;
    }
 
+   /* Show the game selection gA x on the display.
+    *  
+    * @param game: game number 0-9
+    * @return None
+    */
    void showGameSelection(uint8_t game) {
-      uint8_t a[] = {9, 10, 16, game};
-      this->seg.display(a);
-      //this->seg.displayUnit(game, 0, 9);
+      FontText text = fontText("gA 0");
+      text.digits[3] = fontRead('0' + game % 10);
+      this->draw(text.digits, false);
    }
 
    /* Start the countdown functionality of the timer. It starts the given minutes and counts down.
@@ -215,8 +390,13 @@ public:
    void enterCountdown () {
       this->minutes = this->totalMinutes;
       this->seconds = 0;
+      this->ticks = 0;
+      this->tenths = 0;
+      this->endError = 0;
+      this->dash = true;
       this->state = COUNTDOWN;
-      seg.displayTime(this->minutes, this->seconds, true, this->dash);
+      this->stopEffects();
+      this->display->setTime(this->minutes, this->seconds, this->dash);
       this->timer = millis();
    }
 
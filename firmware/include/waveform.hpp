@@ -0,0 +1,203 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/waveform.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the square wave output of the buzzer on timer1. The interrupt
+ *               of timer1 toggles the pin and loads the high or low time of the next level, it
+ *               only writes one GPIO register and timer1. The high and low time are calculated
+ *               once when the tone or the duty changes, so the duty sets the volume without work
+ *               per period. The global PWM frequency of analogWriteFreq is not changed anymore.
+ *               Timer1 is also used by analogWrite and tone of the core, these should not be used
+ *               together with this output. The sample player of pcm.hpp uses timer1 between tones.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Timer1 is shared with the sample player.
+ *               19-10-2026 (MS): The duty sets the volume, the high and low time are calculated per change.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+#define WAVEFORM_PIN           D8
+#define WAVEFORM_CLOCK         5000000UL // Timer1 with TIM_DIV16 counts on 80 MHz / 16
+#define WAVEFORM_MIN_FREQUENCY 20 // Longest half period that fits the 23 bits of timer1 is 1.6 s
+#define WAVEFORM_MAX_FREQUENCY 10000 // At most one interrupt every 50 us
+#define WAVEFORM_DUTY          128 // Duty of 50% of 256, the loudest square wave
+#define WAVEFORM_MIN_TICKS     25 // Shortest high or low time of 5 us, so the interrupt is not too late
+
+/* Class: Waveform
+ * The waveform class generates a square wave on a pin with the interrupt of timer1. There is only one
+ * timer1, so the state of the interrupt is static.
+ */
+class Waveform {
+private:
+   inline static volatile uint32_t mask = 0; // GPIO bit of the pin
+   inline static volatile bool high = false; // Level of the pin
+   inline static volatile uint32_t edges = 0; // Total toggles of the pin
+   inline static volatile uint32_t highTicks = 0; // Time the pin is high in timer1 ticks
+   inline static volatile uint32_t lowTicks = 0; // Time the pin is low in timer1 ticks
+   uint8_t pin;
+   uint32_t halfPeriod; // Half period of the tone in timer1 ticks, 0 when it is off
+   uint8_t duty; // Part of the period that the pin is high, of 256
+
+   /* Calculate the high and low time of the period from the duty. It is a multiply and a shift.
+    *
+    * @param halfPeriod: half period in timer1 ticks
+    * @return None
+    */
+   void split(uint32_t halfPeriod) {
+      uint32_t high = (halfPeriod * 2 * this->duty) >> 8;
+      uint32_t low = halfPeriod * 2 - high;
+      if ( high < WAVEFORM_MIN_TICKS ) {
+         high = WAVEFORM_MIN_TICKS;
+      }
+      if ( low < WAVEFORM_MIN_TICKS ) {
+         low = WAVEFORM_MIN_TICKS;
+      }
+      Waveform::highTicks = high;
+      Waveform::lowTicks = low;
+   }
+
+   /* The interrupt of timer1 toggles the pin. It runs from IRAM, writes the GPIO set or clear register and loads
+    * the time of the next level into timer1.
+    *
+    * @param None
+    * @return None
+    */
+   static void IRAM_ATTR isr() {
+      if ( Waveform::high ) {
+         GPOC = Waveform::mask;
+         timer1_write(Waveform::lowTicks);
+      } else {
+         GPOS = Waveform::mask;
+         timer1_write(Waveform::highTicks);
+      }
+      Waveform::high = !Waveform::high;
+      Waveform::edges++;
+   }
+
+public:
+   Waveform(uint8_t pin = WAVEFORM_PIN): pin(pin), halfPeriod(0), duty(WAVEFORM_DUTY) {
+
+   }
+
+   /* Return the half period of a frequency in timer1 ticks. It is a division, the tones of sound.hpp and the
+    * notes of melody.hpp store the half period that is calculated at compile time.
+    *
+    * @param f: frequency in Hz, it is limited to WAVEFORM_MIN_FREQUENCY - WAVEFORM_MAX_FREQUENCY
+    * @return The half period in ticks, 0 when the frequency is 0.
+    */
+   static constexpr uint32_t toHalfPeriod(uint32_t f) {
+      if ( f == 0 ) {
+         return 0;
+      }
+      f = (f < WAVEFORM_MIN_FREQUENCY ? WAVEFORM_MIN_FREQUENCY : (f > WAVEFORM_MAX_FREQUENCY ? WAVEFORM_MAX_FREQUENCY : f));
+      return WAVEFORM_CLOCK / (2 * f);
+   }
+
+   /* Initialize the pin and attach the interrupt. The pin is low while there is no tone. GPIO0-15 are supported,
+    * GPIO16 does not have the set and clear registers.
+    *
+    * @param None
+    * @return None
+    */
+   void begin() {
+      pinMode(this->pin, OUTPUT);
+      Waveform::mask = (1UL << this->pin);
+      Waveform::high = false;
+      GPOC = Waveform::mask;
+      timer1_attachInterrupt(Waveform::isr);
+   }
+
+   /* Play a tone. When a tone is playing, the new high and low time are used from the next edge and the
+    * phase of the pin is kept.
+    *
+    * @param halfPeriod: half period in timer1 ticks, see toHalfPeriod, 0 stops the tone
+    * @return None
+    */
+   void play(uint32_t halfPeriod) {
+      if ( halfPeriod == 0 ) {
+         this->stop();
+         return;
+      }
+      this->split(halfPeriod);
+      if ( this->halfPeriod == 0 ) { // Timer1 could have been used by the sample player
+         timer1_attachInterrupt(Waveform::isr);
+         timer1_enable(TIM_DIV16, TIM_EDGE, TIM_LOOP);
+         timer1_write(Waveform::lowTicks);
+      }
+      this->halfPeriod = halfPeriod;
+   }
+
+   /* Set the volume of the tone as the duty of the square wave.
+    *
+    * @param duty: part of the period that the pin is high, 0-128 of 256, 128 is the loudest
+    * @return None
+    */
+   void setDuty(uint8_t duty) {
+      this->duty = (duty > WAVEFORM_DUTY ? WAVEFORM_DUTY : duty);
+      if ( this->halfPeriod > 0 ) {
+         this->split(this->halfPeriod);
+      }
+   }
+
+   /* Return the duty of the square wave.
+    *
+    * @param None
+    * @return Duty 0-128 of 256.
+    */
+   uint8_t getDuty() {
+      return this->duty;
+   }
+
+   /* Return the time that the pin is high.
+    *
+    * @param None
+    * @return Time in timer1 ticks.
+    */
+   uint32_t getHighTicks() {
+      return Waveform::highTicks;
+   }
+
+   /* Stop the tone and set the pin low.
+    *
+    * @param None
+    * @return None
+    */
+   void stop() {
+      timer1_disable();
+      GPOC = Waveform::mask;
+      Waveform::high = false;
+      this->halfPeriod = 0;
+   }
+
+   /* Return the half period of the tone that is playing.
+    *
+    * @param None
+    * @return Half period in timer1 ticks, 0 when it is off.
+    */
+   uint32_t getHalfPeriod() {
+      return this->halfPeriod;
+   }
+
+   /* Return the total toggles of the pin by the interrupt.
+    *
+    * @param None
+    * @return Total edges.
+    */
+   uint32_t getEdges() {
+      return Waveform::edges;
+   }
+};
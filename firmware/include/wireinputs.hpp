@@ -0,0 +1,710 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : include/wireinputs.hpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: This file implements the inputs of the defusing wires for the Wires driver. The state of
+ *               the wires is a mask with a bit per wire, bit 0 is wire 1 and a bit is 1 when the wire is
+ *               connected. An input samples and debounces the wires and keeps the wires that are cut.
+ *               - WirePins: the five wires of the D1 mini on A0, D0, D5, D6 and D7.
+ *               - WireShiftRegister: up to 64 wires on a chain of 74HC165 shift registers, read with
+ *                 three pins in one pass.
+ *               - WireLadder: up to 5 wires on a resistor ladder on A0, read with one conversion.
+ *               Every input has the methods begin, loop, sample, getConnected, getCuts, getCutTime and
+ *               getSampleCycles.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code, moved the pins of the wires from wires.hpp.
+ *               19-10-2026 (MS): Resistor ladder on A0.
+ *               19-10-2026 (MS): The calibration of the ladder is only accepted near the nominal full level.
+ *               19-10-2026 (MS): The port conversion that the interrupt calls is in IRAM.
+ *               19-10-2026 (MS): The pulses of the shift registers are given time to settle.
+ * @todo       :
+ */
+#include <Arduino.h>
+#include <type_traits>
+
+#include <analog.hpp>
+
+#define WIRES_ALL          0x1F // The five wires of the D1 mini, bit 0 is wire 1
+#define WIRES_SAMPLE_TIME  20 // Time in ms between two samples
+#define WIRES_COUNTER_BITS 4 // A wire changes after 2^4 = 16 samples that are the same, about 330 ms
+#define WIRES_IRQ          0x1C // Wire 3-5 (D5, D6, D7) have an interrupt on their edges
+#define WIRES_POLLED       0x03 // Wire 1 (A0) and 2 (GPIO16) have no interrupt and are sampled
+#define WIRES_STABLE       50 // Time in ms without an edge before the level of a wire with an interrupt is accepted
+#define WIRES_EDGES        32 // Edges that the interrupt can store between two loops, a power of 2
+
+#define SHIFT_CLOCK        D5 // CP of the 74HC165 chain, the clock of the HSPI
+#define SHIFT_DATA         D6 // QH of the first 74HC165 of the chain, the MISO of the HSPI
+#define SHIFT_LOAD         D7 // PL of the 74HC165 chain, low loads the inputs
+#define SHIFT_SETTLE       1 // Time in us after an edge of PL or CP, the pulse width and the delay of QH on long wires
+
+#define LADDER_INTERVAL    50 // Time in ms between two conversions of the ladder
+#define LADDER_FULL        1023 // ADC value with all wires connected before the calibration
+#define LADDER_TOLERANCE   80 // Band around a level as a percentage of the half gap to the next level
+#define LADDER_AVERAGE     4 // Conversions in the average that is decoded, a power of 2
+#define LADDER_CALIBRATION 8 // Conversions in the average of the calibration
+
+// The smallest unsigned integer with a bit per wire.
+template <uint8_t N>
+using WireMask = typename std::conditional<(N <= 8), uint8_t,
+                 typename std::conditional<(N <= 16), uint16_t,
+                 typename std::conditional<(N <= 32), uint32_t, uint64_t>::type>::type>::type;
+
+/* Class: WireDebounce
+ * The wire debounce class debounces all wires at once with a vertical counter: a counter per wire of which
+ * every bit is in a mask of its own. A sample that differs from the stable level counts up, a sample that is
+ * the same resets the counter. After 2^BITS samples in a row the counter overflows and the stable level of
+ * the wire changes. The work is the same for any number of wires in the mask.
+ */
+template <typename Mask, uint8_t BITS = WIRES_COUNTER_BITS>
+class WireDebounce {
+private:
+   Mask counter[BITS]; // Bit k of the counter of every wire
+   Mask stable; // Debounced level
+
+public:
+   WireDebounce(): counter{ 0 }, stable(0) {
+
+   }
+
+   /* Start from a stable level.
+    *
+    * @param stable: the level, a bit per wire
+    * @return None
+    */
+   void reset(Mask stable) {
+      for ( uint8_t k=0; k < BITS; k++ ) {
+         this->counter[k] = 0;
+      }
+      this->stable = stable;
+   }
+
+   /* Add a sample of all wires.
+    *
+    * @param sample: the level, a bit per wire
+    * @return The debounced level.
+    */
+   Mask update(Mask sample) {
+      Mask delta = sample ^ this->stable;
+      Mask carry = delta;
+      for ( uint8_t k=0; k < BITS; k++ ) {
+         Mask next = this->counter[k] & carry;
+         this->counter[k] = (this->counter[k] ^ carry) & delta;
+         carry = next;
+      }
+      this->stable ^= carry;
+      return this->stable;
+   }
+};
+
+/* Class: WirePins
+ * The wire pins class reads the five wires of the D1 mini: wire 1 on A0 to 3V3, wire 2 on D0 (GPIO16) and
+ * wire 3-5 on D5, D6 and D7 to GND. Wire 3-5 are confirmed on the time of their edges from an interrupt, a
+ * cut is known WIRES_STABLE ms after the edge. GPIO16 has no interrupt and A0 is analog, wire 1 and 2 are
+ * sampled every WIRES_SAMPLE_TIME ms and debounced. There is only one port, so the state that is shared
+ * with the interrupt is static.
+ */
+class WirePins {
+private:
+   inline static volatile uint32_t times[WIRES_EDGES]; // Time in ms of the edges
+   inline static volatile uint8_t levels[WIRES_EDGES]; // Level of wire 3-5 after the edge
+   inline static volatile uint8_t head = 0; // Next place in the ring, written by the interrupt
+   inline static volatile uint8_t tail = 0; // Next edge that the loop handles
+   inline static volatile uint32_t edges = 0; // Total edges of wire 3-5
+   inline static volatile uint32_t overflows = 0; // Edges that did not fit in the ring
+   AnalogInput analog; // Wire 1 on A0, converted on a low rate
+   WireDebounce<uint8_t> debounce; // Wire 1 and 2
+   uint8_t level; // Level of wire 3-5 after the last edge, not debounced
+   uint8_t connected; // Debounced level of the wires
+   uint8_t cuts; // Wires of which a cut is confirmed
+   uint64_t since[5]; // Time in ms of the last edge per wire
+   uint64_t cutAt[5]; // Time in ms of the edge of the confirmed cut per wire, 0 when it is not known
+   uint64_t timer; // Time in ms of the last sample
+   uint32_t overflowsRead; // Overflows of the ring that the loop has seen
+   uint32_t sampleCycles; // CPU cycles of the last sample
+
+   /* Convert the GPIO port to the bits of wire 3-5. A wire that is connected pulls the pin to GND. It is in IRAM,
+    * because the interrupt calls it while the flash cache can be disabled.
+    *
+    * @param gpi: value of the GPI register
+    * @return Mask of wire 3-5, 1 when the wire is connected.
+    */
+   static uint8_t IRAM_ATTR port(uint32_t gpi) {
+      gpi = ~gpi;
+      return (((gpi >> D5) & 0x01) << 2) | (((gpi >> D6) & 0x01) << 3) | (((gpi >> D7) & 0x01) << 4);
+   }
+
+   /* The interrupt of D5, D6 and D7 reads the port once and stores the time and the level in the ring. When the
+    * ring is full the edge is counted as an overflow.
+    *
+    * @param None
+    * @return None
+    */
+   static void IRAM_ATTR isr() {
+      uint8_t h = WirePins::head;
+      uint8_t next = (h + 1) & (WIRES_EDGES - 1);
+      WirePins::edges++;
+      if ( next == WirePins::tail ) {
+         WirePins::overflows++;
+         return;
+      }
+      WirePins::times[h] = millis();
+      WirePins::levels[h] = WirePins::port(GPI);
+      WirePins::head = next; // Written last, the loop reads the edge from now on
+   }
+
+   /* Confirm the stable level of a wire with an interrupt. A cut is kept, also when the wire is connected again
+    * in the same loop.
+    *
+    * @param i: index of the wire (0-4)
+    * @param connected: true when the wire is connected
+    * @param at: time in ms of the edge that started the level
+    * @return None
+    */
+   void confirm(uint8_t i, bool connected, uint64_t at) {
+      uint8_t bit = (1 << i);
+      if ( connected ) {
+         this->connected |= bit;
+      } else if ( this->connected & bit ) {
+         this->connected &= ~bit;
+         this->cuts |= bit;
+         this->cutAt[i] = at;
+      }
+   }
+
+public:
+   WirePins(): level(WIRES_IRQ), connected(WIRES_ALL), cuts(0), since{ 0 }, cutAt{ 0 }, timer(0), overflowsRead(0),
+               sampleCycles(0) {
+
+   }
+
+   /* Initialize the pins and the interrupt. All wires start connected.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void begin(uint64_t millis) {
+      // GND( D0, D5, D6, D7 ), 3V3( A0 ), D0 has an external pull-up
+      pinMode(D0, INPUT_PULLUP);
+      pinMode(D5, INPUT_PULLUP);
+      pinMode(D6, INPUT_PULLUP);
+      pinMode(D7, INPUT_PULLUP);
+
+      this->analog.begin(millis);
+      this->debounce.reset(WIRES_ALL);
+      this->connected = WIRES_ALL;
+      this->cuts = 0;
+      this->timer = millis;
+      for ( uint8_t i=0; i < 5; i++ ) {
+         this->since[i] = millis;
+         this->cutAt[i] = 0;
+      }
+
+      // Wire 3-5 get an interrupt, GPIO16 (wire 2) and A0 (wire 1) do not have one
+      WirePins::head = 0;
+      WirePins::tail = 0;
+      WirePins::overflows = 0;
+      this->overflowsRead = 0;
+      this->level = WirePins::port(GPI);
+      attachInterrupt(digitalPinToInterrupt(D5), WirePins::isr, CHANGE);
+      attachInterrupt(digitalPinToInterrupt(D6), WirePins::isr, CHANGE);
+      attachInterrupt(digitalPinToInterrupt(D7), WirePins::isr, CHANGE);
+   }
+
+   /* Read all wires at once. GPIO12-14 (D6, D7, D5) are one read of the GPI register and GPIO16 (D0) is read
+    * from the GP16I register in the RTC block. Wire 1 is the cached level of the ADC, there is no conversion.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is connected.
+    */
+   uint8_t sample() {
+      return (this->analog.isHigh() ? 0x01 : 0x00) | ((~GP16I & 0x01) << 1) | WirePins::port(GPI);
+   }
+
+   /* The loop method handles the edges of wire 3-5: a level is accepted when the next edge came after
+    * WIRES_STABLE ms, or when WIRES_STABLE ms have passed since the last edge. Wire 1 and 2 are sampled every
+    * WIRES_SAMPLE_TIME ms.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void loop(uint64_t millis) {
+      this->analog.loop(millis);
+
+      while ( WirePins::tail != WirePins::head ) {
+         uint8_t t = WirePins::tail;
+         uint64_t at = millis - ((uint32_t) millis - WirePins::times[t]); // Time of the edge in the 64 bits time
+         uint8_t changed = (WirePins::levels[t] ^ this->level) & WIRES_IRQ;
+         for ( uint8_t i=2; changed != 0 && i < 5; i++ ) {
+            if ( changed & (1 << i) ) {
+               if ( at - this->since[i] >= WIRES_STABLE ) {
+                  this->confirm(i, this->level & (1 << i), this->since[i]);
+               }
+               this->since[i] = at;
+            }
+         }
+         this->level = WirePins::levels[t];
+         WirePins::tail = (t + 1) & (WIRES_EDGES - 1);
+      }
+
+      if ( WirePins::overflows != this->overflowsRead ) { // Edges are lost, start again from the real level
+         this->overflowsRead = WirePins::overflows;
+         this->level = WirePins::port(GPI);
+         for ( uint8_t i=2; i < 5; i++ ) {
+            this->since[i] = millis;
+         }
+      }
+
+      uint8_t pending = (this->level ^ this->connected) & WIRES_IRQ;
+      for ( uint8_t i=2; pending != 0 && i < 5; i++ ) {
+         if ( (pending & (1 << i)) && millis - this->since[i] >= WIRES_STABLE ) {
+            this->confirm(i, this->level & (1 << i), this->since[i]);
+         }
+      }
+
+      if ( (millis - this->timer) > WIRES_SAMPLE_TIME ) {
+         uint32_t begin = ESP.getCycleCount();
+         uint8_t polled = this->debounce.update((this->sample() & WIRES_POLLED) | WIRES_IRQ);
+         this->sampleCycles = ESP.getCycleCount() - begin;
+         this->connected = (this->connected & WIRES_IRQ) | (polled & WIRES_POLLED);
+         this->cuts |= ~this->connected & WIRES_POLLED;
+         this->timer = millis;
+      }
+   }
+
+   /* Return the debounced level of the wires.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is connected.
+    */
+   uint8_t getConnected() {
+      return this->connected;
+   }
+
+   /* Return the wires of which a cut is confirmed since the begin.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is cut.
+    */
+   uint8_t getCuts() {
+      return this->cuts;
+   }
+
+   /* Return the time of the edge of the cut of a wire.
+    *
+    * @param i: index of the wire (0-4)
+    * @return Time in ms, 0 when it is not known because the wire is sampled.
+    */
+   uint64_t getCutTime(uint8_t i) {
+      return this->cutAt[i];
+   }
+
+   /* Return the CPU cycles of the last sample of wire 1 and 2.
+    *
+    * @param None
+    * @return Total cycles.
+    */
+   uint32_t getSampleCycles() {
+      return this->sampleCycles;
+   }
+
+   /* Return the total edges of wire 3-5, including the bouncing of the contacts.
+    *
+    * @param None
+    * @return Total edges.
+    */
+   uint32_t getEdges() {
+      return WirePins::edges;
+   }
+
+   /* Return the ADC of wire 1.
+    *
+    * @param None
+    * @return The analog input.
+    */
+   AnalogInput* getAnalog() {
+      return &this->analog;
+   }
+};
+
+/* Class: WireShiftRegister
+ * The wire shift register class reads N wires on a chain of 74HC165 parallel in, serial out shift registers.
+ * Wire 1-8 are the inputs D0-D7 of the first register of the chain, of which QH is connected to SHIFT_DATA,
+ * wire 9-16 of the second register and so on. An input is pulled up and a connected wire pulls it to GND. The
+ * inputs are loaded with one pulse on SHIFT_LOAD and shifted out with a pulse on SHIFT_CLOCK per bit. The
+ * pulses are written to the GPIO set and clear registers. Every edge of PL and the rising edge of CP are followed
+ * by SHIFT_SETTLE, so the pulses are wide enough and QH is stable before it is read; the time per wire is about
+ * SHIFT_SETTLE. The pins are the pins of the HSPI, so the hardware SPI can be used for long chains.
+ * The wires are sampled every WIRES_SAMPLE_TIME ms and debounced all at once.
+ */
+template <uint8_t N>
+class WireShiftRegister {
+   static_assert(N >= 1 && N <= 64, "A chain of 1 to 8 74HC165 shift registers reads 1 to 64 wires");
+
+private:
+   typedef WireMask<N> Mask;
+   static constexpr Mask ALL = (N == 64 ? (Mask) ~(Mask) 0 : (Mask) (((uint64_t) 1 << N) - 1));
+   static constexpr uint8_t CHIPS = (N + 7) / 8;
+
+   WireDebounce<Mask> debounce;
+   Mask connected; // Debounced level of the wires
+   Mask cuts; // Wires of which a cut is confirmed
+   uint64_t timer; // Time in ms of the last sample
+   uint32_t sampleCycles; // CPU cycles of the last sample
+
+public:
+   WireShiftRegister(): connected(ALL), cuts(0), timer(0), sampleCycles(0) {
+
+   }
+
+   /* Initialize the pins. All wires start connected.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void begin(uint64_t millis) {
+      pinMode(SHIFT_DATA, INPUT);
+      pinMode(SHIFT_CLOCK, OUTPUT);
+      pinMode(SHIFT_LOAD, OUTPUT);
+      GPOC = (1UL << SHIFT_CLOCK);
+      GPOS = (1UL << SHIFT_LOAD);
+
+      this->debounce.reset(ALL);
+      this->connected = ALL;
+      this->cuts = 0;
+      this->timer = millis;
+   }
+
+   /* Read all wires in one pass: load the inputs of the chain and shift out all bits. QH is the input D7 of the
+    * first register, after 8 clocks the D7 of the next one.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is connected.
+    */
+   Mask sample() {
+      GPOC = (1UL << SHIFT_LOAD);
+      delayMicroseconds(SHIFT_SETTLE);
+      GPOS = (1UL << SHIFT_LOAD);
+      delayMicroseconds(SHIFT_SETTLE);
+
+      Mask inputs = 0;
+      for ( uint8_t c=0; c < CHIPS; c++ ) {
+         for ( int8_t b=7; b >= 0; b-- ) {
+            inputs |= (Mask) ((GPI >> SHIFT_DATA) & 0x01) << (c * 8 + b);
+            GPOS = (1UL << SHIFT_CLOCK);
+            delayMicroseconds(SHIFT_SETTLE); // QH shifts on the rising edge
+            GPOC = (1UL << SHIFT_CLOCK);
+         }
+      }
+      return ~inputs & ALL;
+   }
+
+   /* The loop method samples and debounces all wires every WIRES_SAMPLE_TIME ms.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void loop(uint64_t millis) {
+      if ( (millis - this->timer) > WIRES_SAMPLE_TIME ) {
+         uint32_t begin = ESP.getCycleCount();
+         this->connected = this->debounce.update(this->sample());
+         this->sampleCycles = ESP.getCycleCount() - begin;
+         this->cuts |= ~this->connected & ALL;
+         this->timer = millis;
+      }
+   }
+
+   /* Return the debounced level of the wires.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is connected.
+    */
+   Mask getConnected() {
+      return this->connected;
+   }
+
+   /* Return the wires of which a cut is confirmed since the begin.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is cut.
+    */
+   Mask getCuts() {
+      return this->cuts;
+   }
+
+   /* Return the time of the edge of the cut of a wire, the wires are sampled so it is not known.
+    *
+    * @param i: index of the wire
+    * @return Always 0.
+    */
+   uint64_t getCutTime(uint8_t) {
+      return 0;
+   }
+
+   /* Return the CPU cycles of the last sample of all wires.
+    *
+    * @param None
+    * @return Total cycles.
+    */
+   uint32_t getSampleCycles() {
+      return this->sampleCycles;
+   }
+};
+
+/* Class: WireLadder
+ * The wire ladder class reads N wires with one conversion of A0. The wires are in series between 3V3 and A0,
+ * every wire shorts a resistor: wire 1 shorts R, wire 2 shorts 2R, wire 3 4R and so on. A0 has a pull-down of
+ * 2^N * R to GND. A cut wire adds its resistor, so the total resistance is the mask of the cut wires
+ * times R and every combination of cut wires has its own level:
+ *
+ *    ADC = full * 2^N / (2^N + cut)
+ *
+ * The levels of all combinations and the thresholds between them are calculated once from the ADC value with
+ * all wires connected (full). The average of the last LADDER_AVERAGE conversions is decoded with a binary
+ * search of the thresholds, one conversion per LADDER_INTERVAL. An average outside the tolerance band of its
+ * level is not used, e.g. while a wire is cut, and counted as invalid. The levels get closer with every wire,
+ * the 10 bits of the ADC allow up to 5 wires. With 5 wires the last levels are 8 LSB apart and have a band of
+ * 3 LSB, the average keeps the noise of the ADC inside it.
+ */
+template <uint8_t N>
+class WireLadder {
+   static_assert(N >= 1 && N <= 5, "The 10 bits ADC decodes a resistor ladder of 1 to 5 wires");
+
+private:
+   typedef WireMask<N> Mask;
+   static constexpr Mask ALL = (Mask) ((1 << N) - 1);
+   static constexpr uint8_t LEVELS = (1 << N);
+   static constexpr uint16_t RATIO = (1 << N); // Pull-down resistor as a multiple of R
+   static constexpr uint16_t FULL_MIN = (LADDER_FULL + LADDER_FULL * RATIO / (RATIO + 1)) / 2 + 1; // Closer to all wires than to wire 1 cut
+
+   uint16_t levels[LEVELS]; // ADC value per mask of cut wires, it goes down with the mask
+   uint16_t thresholds[LEVELS - 1]; // Between level k and k + 1
+   uint16_t bands[LEVELS]; // Largest distance of a conversion to its level
+   uint16_t full; // ADC value with all wires connected
+   uint16_t values[LADDER_AVERAGE]; // Last conversions
+   uint16_t sum; // Sum of the last conversions
+   uint8_t index; // Next conversion to replace
+   WireDebounce<Mask, 2> debounce; // A wire changes after 4 conversions, 200 ms
+   Mask connected; // Debounced level of the wires
+   Mask cuts; // Wires of which a cut is confirmed
+   uint64_t timer; // Time in ms of the last conversion
+   uint32_t reads; // Total conversions
+   uint32_t invalid; // Averages outside the tolerance bands
+   uint32_t sampleCycles; // CPU cycles of the last sample
+
+   /* Calculate the levels, thresholds and tolerance bands from the ADC value with all wires connected.
+    *
+    * @param None
+    * @return None
+    */
+   void table() {
+      for ( uint8_t k=0; k < LEVELS; k++ ) {
+         this->levels[k] = (uint16_t) ((uint32_t) this->full * RATIO / (RATIO + k));
+      }
+      for ( uint8_t k=0; k < LEVELS - 1; k++ ) {
+         this->thresholds[k] = (this->levels[k] + this->levels[k + 1]) / 2;
+      }
+      for ( uint8_t k=0; k < LEVELS; k++ ) {
+         uint16_t above = (k > 0 ? this->levels[k - 1] - this->levels[k] : this->levels[0] - this->levels[1]);
+         uint16_t below = (k < LEVELS - 1 ? this->levels[k] - this->levels[k + 1] : above);
+         this->bands[k] = (uint16_t) ((uint32_t) (above < below ? above : below) * LADDER_TOLERANCE / 200);
+      }
+   }
+
+public:
+   WireLadder(): full(LADDER_FULL), values{ 0 }, sum(0), index(0), connected(ALL), cuts(0), timer(0), reads(0), invalid(0), sampleCycles(0) {
+      this->table();
+   }
+
+   /* Calibrate the levels with all wires connected, the average of LADDER_CALIBRATION conversions is the full
+    * level. An average that is closer to the nominal level of wire 1 cut than to LADDER_FULL can be a ladder
+    * with one or more cut wires, e.g. mask 1 to 4 with 5 wires, and is not used. So the calibration corrects
+    * at most half of the first step, 15 LSB with 5 wires and 56 LSB with 3 wires.
+    *
+    * @param None
+    * @return True when the levels are calibrated.
+    */
+   bool calibrate() {
+      uint32_t sum = 0;
+      for ( uint8_t i=0; i < LADDER_CALIBRATION; i++ ) {
+         sum += analogRead(A0);
+      }
+      this->reads += LADDER_CALIBRATION;
+      if ( sum / LADDER_CALIBRATION < FULL_MIN ) {
+         return false;
+      }
+      this->full = sum / LADDER_CALIBRATION;
+      this->table();
+      return true;
+   }
+
+   /* Initialize the input. All wires start connected, so the ladder is calibrated.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void begin(uint64_t millis) {
+      this->calibrate();
+      for ( uint8_t i=0; i < LADDER_AVERAGE; i++ ) {
+         this->values[i] = this->full;
+      }
+      this->sum = this->full * LADDER_AVERAGE;
+      this->index = 0;
+      this->debounce.reset(ALL);
+      this->connected = ALL;
+      this->cuts = 0;
+      this->timer = millis;
+   }
+
+   /* Decode an ADC value to the wires.
+    *
+    * @param value: the ADC value
+    * @return Mask of the cut wires, or LEVELS when the value is outside the tolerance band of its level.
+    */
+   uint8_t decode(uint16_t value) {
+      uint8_t low = 0;
+      uint8_t high = LEVELS - 1;
+      while ( low < high ) {
+         uint8_t middle = (low + high) / 2;
+         if ( value > this->thresholds[middle] ) {
+            high = middle;
+         } else {
+            low = middle + 1;
+         }
+      }
+      uint16_t distance = (value > this->levels[low] ? value - this->levels[low] : this->levels[low] - value);
+      return distance <= this->bands[low] ? low : LEVELS;
+   }
+
+   /* Read all wires with one conversion, without the average.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is connected. The debounced level when the conversion is
+    *         invalid.
+    */
+   Mask sample() {
+      this->reads++;
+      uint8_t cut = this->decode(analogRead(A0));
+      return cut == LEVELS ? this->connected : ~cut & ALL;
+   }
+
+   /* The loop method converts once every LADDER_INTERVAL ms and debounces the decoded average. An invalid
+    * average is skipped, it does not restart the debounce of a wire that changes.
+    *
+    * @param millis: current time in ms
+    * @return None
+    */
+   void loop(uint64_t millis) {
+      if ( (millis - this->timer) >= LADDER_INTERVAL ) {
+         uint32_t begin = ESP.getCycleCount();
+         uint16_t value = analogRead(A0);
+         this->reads++;
+         this->sum = this->sum - this->values[this->index] + value;
+         this->values[this->index] = value;
+         this->index = (this->index + 1) & (LADDER_AVERAGE - 1);
+
+         uint8_t cut = this->decode((this->sum + LADDER_AVERAGE / 2) / LADDER_AVERAGE);
+         if ( cut == LEVELS ) {
+            this->invalid++;
+         } else {
+            this->connected = this->debounce.update(~cut & ALL);
+            this->cuts |= ~this->connected & ALL;
+         }
+         this->sampleCycles = ESP.getCycleCount() - begin;
+         this->timer = millis;
+      }
+   }
+
+   /* Return the ADC value of a combination of cut wires.
+    *
+    * @param cut: mask of the cut wires
+    * @return The ADC value.
+    */
+   uint16_t getLevel(uint8_t cut) {
+      return this->levels[cut];
+   }
+
+   /* Return the ADC value with all wires connected.
+    *
+    * @param None
+    * @return The ADC value.
+    */
+   uint16_t getFull() {
+      return this->full;
+   }
+
+   /* Return the tolerance band of a combination of cut wires.
+    *
+    * @param cut: mask of the cut wires
+    * @return Largest distance of a conversion to the level.
+    */
+   uint16_t getBand(uint8_t cut) {
+      return this->bands[cut];
+   }
+
+   /* Return the debounced level of the wires.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is connected.
+    */
+   Mask getConnected() {
+      return this->connected;
+   }
+
+   /* Return the wires of which a cut is confirmed since the begin.
+    *
+    * @param None
+    * @return Mask with a bit per wire, 1 when the wire is cut.
+    */
+   Mask getCuts() {
+      return this->cuts;
+   }
+
+   /* Return the time of the edge of the cut of a wire, the wires are sampled so it is not known.
+    *
+    * @param i: index of the wire
+    * @return Always 0.
+    */
+   uint64_t getCutTime(uint8_t) {
+      return 0;
+   }
+
+   /* Return the CPU cycles of the last sample of all wires.
+    *
+    * @param None
+    * @return Total cycles.
+    */
+   uint32_t getSampleCycles() {
+      return this->sampleCycles;
+   }
+
+   /* Return the total conversions of the ADC.
+    *
+    * @param None
+    * @return Total conversions.
+    */
+   uint32_t getReads() {
+      return this->reads;
+   }
+
+   /* Return the total averages that were outside the tolerance bands.
+    *
+    * @param None
+    * @return Total invalid averages.
+    */
+   uint32_t getInvalid() {
+      return this->invalid;
+   }
+};
@@ -20,6 +20,12 @@
  * @updates    : 20-02-2024 (MS): Initial code.
  *               16-06-2024 (MS): Created the first release version.
  *               27-03-2026 (MS): Improved code and documentation.
+ *               19-10-2026 (MS): The mistakes set the tempo of the ticking, see tempo.hpp.
+ *               19-10-2026 (MS): All wires are sampled in one mask, the debounce uses bitwise operations.
+ *               19-10-2026 (MS): Wire 1 on A0 is converted on a low rate, see analog.hpp.
+ *               19-10-2026 (MS): Wire 3-5 are confirmed on the time of their edges from an interrupt.
+ *               19-10-2026 (MS): Any number of wires up to 64 with an input of wireinputs.hpp.
+ *               19-10-2026 (MS): The order is shuffled from a seed that can be replayed, see puzzle.hpp.
  * @todo       : 
  */
 #include <driver.h>
@@ -28,54 +34,51 @@
 #include <math.h>
 
 #include <buzzer.hpp>
+#include <puzzle.hpp>
+#include <wireinputs.hpp>
 
-// Enumaration variable to define the order of the wires.
-enum WIRE_NUMBER {
-  WIRE_1,
-  WIRE_2,
-  WIRE_3,
-  WIRE_4,
-  WIRE_5
-};
+#define WIRES_TOTAL        5 // Wires of the D1 mini, see WirePins
 
 /**
  * @class Wires
  * @brief Beheert de status en ontmantelingslogica van de fysieke draden van de bom.
  * 
- * Deze klasse implementeert de IDriver interface en handelt het inlezen van de draden,
- * de softwarematige ontstoring (debounce) en de volgorde van doorknippen af.
+ * Deze klasse implementeert de IDriver interface en handelt de volgorde van doorknippen af. Het inlezen en
+ * ontstoren van de draden doet de input, zie wireinputs.hpp. De stand van alle draden is een masker met een
+ * bit per draad, zodat het werk per sample niet groeit met het aantal draden.
+ * @tparam N Aantal draden, 1-64.
+ * @tparam Input Input van de draden, bijvoorbeeld WirePins of WireShiftRegister<N>.
  */
+template <uint8_t N = WIRES_TOTAL, typename Input = WirePins>
 class Wires: public IDriver {
+  static_assert(N >= 1 && N <= 64, "Wires supports 1 to 64 wires");
+
 private:
-  uint64_t timer;           ///< Timer voor non-blocking updates (anti-dender).
-  uint8_t order[5];         ///< De juiste volgorde waarin draden doorgeknipt moeten worden.
-  char code[5];             ///< Hexadecimale code gegenereerd uit de volgorde (verhoogd naar 5 voor null-terminator).
-  uint8_t wires[5];         ///< Accumulator voor ontstoring per draad.
-  uint8_t orderCut[5];      ///< Bijgehouden volgorde van doorgeknipte draden.
+  typedef WireMask<N> Mask;
+
+  // Bits per draadnummer in de code, 3 bits voor 5 draden.
+  static constexpr uint8_t BITS = (N < 2 ? 1 : (N < 4 ? 2 : (N < 8 ? 3 : (N < 16 ? 4 : (N < 32 ? 5 : (N < 64 ? 6 : 7))))));
+  static constexpr uint8_t DIGITS = (N * BITS + 3) / 4; // Hexadecimale karakters van de code
+
+  uint8_t order[N];         ///< De juiste volgorde waarin draden doorgeknipt moeten worden.
+  uint32_t seed;            ///< Seed waaruit de volgorde is gegenereerd.
+  bool replay;              ///< De volgende setup gebruikt de ingestelde seed in plaats van een nieuwe.
+  char code[DIGITS + 1];    ///< Hexadecimale code gegenereerd uit de volgorde, met null-terminator.
+  Input input;              ///< Leest en ontstoort de draden.
+  Mask reported;            ///< Draden waarvan de knip al is afgehandeld, bit per draad.
+  uint32_t latencyLast;     ///< Tijd in ms van de flank van de laatste knip tot de feedback.
+  uint32_t latencyMax;      ///< Langste tijd in ms van een flank van een knip tot de feedback.
+  uint8_t orderCut[N];      ///< Bijgehouden volgorde van doorgeknipte draden.
   uint8_t totalMistakes;    ///< Aantal fouten gemaakt door de gebruiker.
   uint8_t totalWireCuts;    ///< Totaal aantal draden dat momenteel is doorgeknipt.
   Buzzer* buzzer;           ///< Referentie naar de buzzer voor feedback.
 
-  /**
-   * @brief Controleert of een draadnummer al in de gegenereerde volgorde staat.
-   * @param n Het draadnummer (1-5).
-   * @return True als de draad al aanwezig is, anders false.
-   */
-  bool inWireOrder(uint8_t n) {
-    for (uint8_t i=0; i < 5; i++ ) {
-      if ( this->order[i] == n ) {
-        return true;
-      }
-    }
-    return false;
-  }
-
   /**
    * @brief Print de gegenereerde draadvolgorde naar de seriële monitor voor debugging.
    */
   void printWireOrder () {
     printf("Wire order: \n");
-    for (uint8_t i=0; i < 5; i++ ) {
+    for (uint8_t i=0; i < N; i++ ) {
       printf("%d\n", this->order[i]);
     }
     printf("\n");
@@ -83,56 +86,50 @@ private:
 
   /**
    * @brief Genereert een unieke hex-code gebaseerd op de ontmantelingsvolgorde.
-   * De code wordt gebruikt in de web-interface.
+   * De code wordt gebruikt in de web-interface. Draad i staat op bit i*BITS, zonder voorloopnullen. Voor 5 draden
+   * zijn dit 15 bits in 4 hex karakters.
    */
   void createCode () {
-    uint32_t c = 0;
-    for (uint8_t i=0; i < 5; i++ ) {
-      c = c + (this->order[i] << (i*3));
+    uint8_t length = 0;
+    for ( int8_t d=DIGITS-1; d >= 0; d-- ) {
+      uint8_t nibble = 0;
+      for ( uint8_t b=0; b < 4; b++ ) {
+        uint16_t bit = d * 4 + b;
+        if ( bit < N * BITS ) {
+          nibble |= ((this->order[bit / BITS] >> (bit % BITS)) & 0x01) << b;
+        }
+      }
+      if ( nibble != 0 || length > 0 || d == 0 ) {
+        this->code[length++] = "0123456789ABCDEF"[nibble];
+      }
     }
-    // 15 bits max (5 * 3 bits) past in 4 hex karakters + \0. Buffer moet 5 groot zijn.
-    snprintf(this->code, sizeof(this->code), "%X", c);
+    this->code[length] = '\0';
     printf("Code: %s\n", this->code);
   }
 
   /**
-   * @brief Genereert een willekeurige volgorde voor de 5 draden.
+   * @brief Genereert de volgorde voor de N draden uit de seed.
+   * De draden 1-N worden geschud met Fisher-Yates, de tijd is gelijk voor elke seed. Dezelfde seed geeft altijd
+   * dezelfde volgorde.
    */
-  void createRandomWireOrder() {
-    //printf("Create random order\n");
-    for (uint8_t i=0; i < 5; i++ ) {
-      uint8_t n = (uint8_t) random(1, 6);
-      while ( this->inWireOrder(n) ) {
-        n = (uint8_t) random(1, 6);
-      }
-      //printf("Found number: %d\n", n);
-      this->order[i] = n;
+  void createWireOrder() {
+    for (uint8_t i=0; i < N; i++ ) {
+      this->order[i] = i + 1;
     }
+    Puzzle puzzle(this->seed);
+    puzzle.shuffle(this->order, N);
+    printf("Seed: %08X\n", (unsigned int) this->seed);
     this->createCode();
   }
 
-  /**
-   * @brief Controleert of een specifieke draad al als "doorgeknipt" is geregistreerd.
-   * @param n Draadnummer.
-   * @return True als de draad al is doorgeknipt.
-   */
-  bool inWireOrderCut(uint8_t n) {
-    for (uint8_t i=0; i < 5; i++ ) {
-      if ( this->orderCut[i] == n ) {
-        return true;
-      }
-    }
-    return false;
-  }
-
   /**
    * @brief Registreert een nieuwe draadknip en valideert of dit de juiste draad was.
-   * Bij een foutieve draad wordt de ticking-snelheid van de buzzer verhoogd.
+   * Een foutieve draad telt als fout, de tempo driver verhoogt daarmee de ticking-snelheid.
    * @param n Het nummer van de doorgeknipte draad.
    * @return True als de knip correct was volgens de volgorde.
    */
   bool addWireOrderCut(uint8_t n) {
-    for (uint8_t i=0; i < 5; i++ ) {
+    for (uint8_t i=0; i < N; i++ ) {
       if ( this->orderCut[i] == 0 ) { // Found empty spot, put it in
         if ( this->order[i] == n ) { // correct wire
           printf("CORRECT WIRE\n");
@@ -143,8 +140,7 @@ private:
         } else { // not correct wire
           printf("NOT CORRECT WIRE\n");
           this->buzzer->beepNotCorrectWire();
-          this->buzzer->startTicking(300); // double speed
-          for (uint8_t i=0; i < 5; i++ ) {
+          for (uint8_t i=0; i < N; i++ ) {
             if ( this->order[i] == n ) { // find position of cut
               this->orderCut[i] = n; // put it on the correct position.
             }
@@ -161,12 +157,13 @@ public:
    * @brief Constructor voor de Wires klasse.
    * @param buzzer Pointer naar de Buzzer instantie voor audio feedback.
    */
-  Wires(Buzzer* buzzer): timer(0), totalMistakes(0), totalWireCuts(0), buzzer(buzzer) {
-    for ( uint8_t i=0; i < 5; i++ ) { // Initialize the arrays
+  Wires(Buzzer* buzzer): seed(1), replay(false), reported(0), latencyLast(0), latencyMax(0), totalMistakes(0), totalWireCuts(0),
+                         buzzer(buzzer) {
+    for ( uint8_t i=0; i < N; i++ ) { // Initialize the arrays
       this->order[i] = 0;
-      this->wires[i] = 0;
       this->orderCut[i] = 0;
     }
+    this->code[0] = '\0';
   }
 
   ~Wires() {
@@ -175,122 +172,135 @@ public:
 
   /**
    * @brief Initialiseert de hardware pinnen en genereert de random volgorde.
-   * Wordt aangeroepen tijdens boot of reset van het spel.
+   * Wordt aangeroepen tijdens boot of reset van het spel. De seed komt van de hardware random generator, tenzij
+   * een seed is ingesteld met setSeed.
    * @return 0 bij succes.
    */
   uint8_t setup() {
-    this->timer = 0;
     this->totalMistakes = 0;
     this->totalWireCuts = 0;
-    for ( uint8_t i=0; i < 5; i++ ) { // Initialize the arrays
+    this->reported = 0;
+    this->latencyLast = 0;
+    this->latencyMax = 0;
+    for ( uint8_t i=0; i < N; i++ ) { // Initialize the arrays
       this->order[i] = 0;
-      this->wires[i] = 0;
       this->orderCut[i] = 0;
     }
 
-    this->createRandomWireOrder();
-
-    // GND( D0, D5, D6, D7 ), 3V3( A0 )
-    // D0 external pullup.
-    pinMode(D0, INPUT_PULLUP);
-    pinMode(D5, INPUT_PULLUP);
-    pinMode(D6, INPUT_PULLUP);
-    pinMode(D7, INPUT_PULLUP);
+    this->seed = (this->replay ? this->seed : Puzzle::hardwareSeed());
+    this->replay = false;
+    this->createWireOrder();
+    this->input.begin(millis());
 
     Serial.println("Setup Wires Ready!");
 
     return 0;
   }
 
+  /**
+   * @brief Leest alle draden in één keer in een masker, zie de input.
+   * @return Masker met een bit per draad (bit 0 is draad 1), 1 als de draad verbonden is.
+   */
+  Mask sample() {
+    return this->input.sample();
+  }
+
   /**
    * @brief Leest de actuele elektrische status van een specifieke draad.
-   * @param n Draadnummer (1-5).
+   * @param n Draadnummer (1-N).
    * @return True als de draad verbonden is, false als deze onderbroken is.
    */
   bool stateWire (uint8_t n) {
-    switch (n) {
-      case 1:
-        return analogRead(A0) > 500;
-      case 2:
-        return digitalRead(D0) == LOW;
-        break;
-      case 3:
-        return digitalRead(D5) == LOW;
-        break;
-      case 4:
-        return digitalRead(D6) == LOW;
-        break;
-      case 5:
-        return digitalRead(D7) == LOW;
-        break;
+    if ( n < 1 || n > N ) {
+      printf("Wire ERROR\n");
+      return false;
     }
-    printf("Wire ERROR\n");
-    return false;
+    return (this->input.sample() >> (n-1)) & 0x01;
   }
 
   /**
    * @brief Debug functie om de status van alle draden naar de seriële poort te schrijven.
    */
   void printWires () {
+    Mask sample = this->input.sample();
+    Mask connected = this->input.getConnected();
     printf("Wires: \n");
-    for ( uint8_t i=0 ; i < 5; i++ ) {
-      printf("- %d => (%d, %d)\n", i+1, this->stateWire(i+1), this->wires[i]);
+    for ( uint8_t i=0 ; i < N; i++ ) {
+      printf("- %d => (%d, %d)\n", i+1, (int) ((sample >> i) & 0x01), (int) ((connected >> i) & 0x01));
     }
   }
 
   /**
-   * @brief Hoofd-loop voor de draden. Verzorgt softwarematige ontstoring en checkt op nieuwe onderbrekingen.
-   * Een draad wordt als "doorgeknipt" beschouwd als de accumulator boven de 128 uitkomt.
+   * @brief Hoofd-loop voor de draden. De input leest en ontstoort de draden. Alleen als er een nieuwe onderbreking
+   * is worden de draden één voor één afgehandeld.
    * 
    * @param millis De huidige systeem-tijd in milliseconden.
    * @return Zero is successfull and non-zero when an error occurred.
    */
   uint8_t loop(uint64_t millis) {
-    if ( this->timer == 0 ) {
-      this->timer = millis;
-    }
-
-    // low-pass filter to remove high freq of button press (anti-dender), RC=20ms
-    if ( (millis - this->timer) > 20 ) {
-      for ( uint8_t i=0; i < 5; i++ ) {
-        if ( !this->stateWire(i+1) ) {
-          if ( this->wires[i] < 255 ) {
-            this->wires[i] = this->wires[i] + 1;
-          }
-        } else {
-          if ( this->wires[i] > 0 ) {
-            this->wires[i] = this->wires[i] - 1;
-          }
-        }
-      }
-      this->timer = millis;
-    }
+    this->input.loop(millis);
 
     // Check real wire cutting order
-    for ( uint8_t i=0; i < 5; i++ ) {
-      if ( this->wires[i] > 128 ) { // Wire is cut
-        if ( !this->inWireOrderCut(i+1) ) { // This is the next wire that has been cut
-          if ( !this->addWireOrderCut(i+1) ) { // correct wire
-            this->totalMistakes++;
-          }
-          this->totalWireCuts++;
-          printf("Wire cut detected: %d\n", i+1);
+    Mask cut = this->input.getCuts() & ~this->reported;
+    for ( uint8_t i=0; cut != 0; i++, cut >>= 1 ) {
+      if ( cut & 0x01 ) { // This is the next wire that has been cut
+        this->reported |= ((Mask) 1 << i);
+        if ( !this->addWireOrderCut(i+1) ) { // correct wire
+          this->totalMistakes++;
+        }
+        this->totalWireCuts++;
+        uint64_t at = this->input.getCutTime(i);
+        if ( at != 0 ) { // The time of the edge of the cut is known
+          this->latencyLast = (uint32_t) (millis - at);
+          this->latencyMax = (this->latencyLast > this->latencyMax ? this->latencyLast : this->latencyMax);
         }
+        printf("Wire cut detected: %d\n", i+1);
       }
     }
 
-    // Check
-
     return 0;
   }
 
+  /**
+   * @brief Geeft de ontstoorde stand van de draden terug.
+   * @return Masker met een bit per draad (bit 0 is draad 1), 1 als de draad verbonden is.
+   */
+  Mask getConnected() {
+    return this->input.getConnected();
+  }
+
+  /**
+   * @brief Geeft de input van de draden terug, voor de statistieken.
+   * @return Pointer naar de input.
+   */
+  Input* getInput() {
+    return &this->input;
+  }
+
+  /**
+   * @brief Geeft de tijd van de flank van de laatste knip tot de feedback terug, als de input de tijd van de
+   * flank kent.
+   * @return Tijd in ms.
+   */
+  uint32_t getLatencyLast() {
+    return this->latencyLast;
+  }
+
+  /**
+   * @brief Geeft de langste tijd van de flank van een knip tot de feedback terug.
+   * @return Tijd in ms.
+   */
+  uint32_t getLatencyMax() {
+    return this->latencyMax;
+  }
+
   /**
    * @brief Geeft het totaal aantal correct of foutief doorgeknipte draden terug.
    * @return Aantal doorgeknipte draden.
    */
   uint8_t totalWiresCut() {
     uint8_t total = 0;
-    for (uint8_t i=0; i < 5; i++ ) {
+    for (uint8_t i=0; i < N; i++ ) {
       if ( this->orderCut[i] != 0 ) {
         total++;
       }
@@ -298,6 +308,23 @@ public:
     return total;
   }
 
+  /**
+   * @brief Stelt de seed in van de puzzel die de volgende setup genereert, zodat de leraar een spel kan herhalen.
+   * @param seed De seed van het spel, zie getSeed.
+   */
+  void setSeed(uint32_t seed) {
+    this->seed = (seed != 0 ? seed : 1);
+    this->replay = true;
+  }
+
+  /**
+   * @brief Geeft de seed terug waaruit de huidige volgorde is gegenereerd.
+   * @return De seed.
+   */
+  uint32_t getSeed() {
+    return this->seed;
+  }
+
   /**
    * @brief Geeft de gegenereerde deactivatiecode terug.
    * @return Pointer naar de hex-string.
@@ -306,12 +333,20 @@ public:
     return this->code;
   }
 
+  /**
+   * @brief Geeft het aantal fouten van de gebruiker terug.
+   * @return Aantal fouten.
+   */
+  uint8_t getMistakes() {
+    return this->totalMistakes;
+  }
+
   /**
    * @brief Controleert of de gebruiker heeft gewonnen (alle draden door met max 1 fout).
    * @return True als gewonnen.
    */
   bool isWin () { // one or zero mistakes
-    return (this->totalWireCuts == 5 && this->totalMistakes < 2);
+    return (this->totalWireCuts == N && this->totalMistakes < 2);
   }
 
   /**
@@ -18,9 +18,11 @@
  *               students cyber security skills and knowledge. When the firmware
  *               starts, the teacher is able to select first the game that will
  *               be played. Enter the game is done using a long button press. 
- *               Then the time that the students get is selected and again with a
- *               long button press it is selected. To start the game the button
- *               is pressed again. The timer will start and the students need to
+ *               Then the time that the students get is selected: a click adds 5
+ *               minutes, holding the button shortly adds minutes faster and faster,
+ *               a triple click goes back to the game. A long button press
+ *               selects the time that was shown when the press started. To
+ *               start the game the button is clicked again. The timer will start and the students need to
  *               solve the puzzle to defuse the (fake) bomb.
  *               The hardware:
  *               - Passive buzzer connected to D8 and GND.
@@ -36,6 +38,21 @@
  *               16-06-2024 (MS): Created the first release version.
  *               22-09-2024 (MS): Added Game 2 for the first year students including game selection.
  *               27-03-2026 (MS): Improved code and documentation.
+ *               19-10-2026 (MS): Added the statistics webpage /stats.
+ *               19-10-2026 (MS): The displays are driven by the display manager.
+ *               19-10-2026 (MS): The ticking speeds up with the time left and the mistakes.
+ *               19-10-2026 (MS): The bomb explodes with a sampled sound when the game is lost.
+ *               19-10-2026 (MS): The menus use the gestures of the button.
+ *               19-10-2026 (MS): The cycles of sampling the wires are shown on /stats.
+ *               19-10-2026 (MS): The conversions of the ADC of wire 1 are shown on /stats.
+ *               19-10-2026 (MS): The latency of a wire cut to the feedback is shown on /stats.
+ *               19-10-2026 (MS): The wires driver is a template for the number of wires and the input.
+ *               19-10-2026 (MS): The Wi-Fi throughput with an ADC interval is measured with /throughput in a
+ *                                debug build with HTB_DEBUG_THROUGHPUT.
+ *               19-10-2026 (MS): The channel and the puzzle come from the hardware random generator, a game is
+ *                                replayed with its seed.
+ *               19-10-2026 (MS): The time is selected with a long press, like the game.
+ *               19-10-2026 (MS): A seed is replayed with a command on the serial port instead of /admin?seed.
  * @todo       : 
  */
 #include <Arduino.h>
@@ -45,10 +62,13 @@
 #include <EEPROM.h>
 #include <driver.h>
 #include <website.hpp>
+#include <i2cqueue.hpp>
+#include <displaymanager.hpp>
 #include <timer.hpp>
 #include <buzzer.hpp>
 #include <button.hpp>
 #include <wires.hpp>
+#include <tempo.hpp>
 
 /// @brief Unieke SSID gebaseerd op de Chip ID.
 String SSID = "HTB-" + String(system_get_chip_id());
@@ -56,26 +76,47 @@ String SSID = "HTB-" + String(system_get_chip_id());
 /// @brief Wi-Fi wachtwoord (wordt geladen uit EEPROM of random gegenereerd).
 String PASSWORD = "";
 
-int channel = random(1, 13);
+int channel = 1; // Chosen in setup from the hardware random generator
 uint8_t GAME_SELECTION = 0;
 
+#ifdef HTB_DEBUG_THROUGHPUT // Debug build only, see platformio.ini
+#define THROUGHPUT_BYTES   262144 // Bytes that /throughput sends, 256 kB
+#define THROUGHPUT_CHUNK   1024 // Bytes per write, the drivers loop between two writes
+#define THROUGHPUT_ADC_MIN 10 // Shortest ADC interval in ms that /throughput accepts
+#define THROUGHPUT_ADC_MAX 1000 // Longest ADC interval in ms that /throughput accepts
+
+uint16_t throughputInterval = 0; // ADC interval in ms of the last /throughput
+uint32_t throughputKbps = 0; // Wi-Fi throughput in kbit/s of the last /throughput
+#endif
+
 // Forward declaration of the different routes for the webpages.
 void handleRoot();
 void handleAdmin();
 void handleCode();
+void handleStats();
+#ifdef HTB_DEBUG_THROUGHPUT
+void handleThroughput();
+#endif
 void handleNotFound();
+void handleSerial();
 String webDefusingCode = "";
 uint8_t webDefusingCodeTrials = 0;
 
 // Instantieer hardware drivers.
-Timer timer;
+I2CQueue i2c;
+DisplayManager displays(&i2c); // The countdown is display 0 on 0x70, more displays are added with the total
+Timer timer(displays.get(0));
 Buzzer buzzer;
 Button button;
-Wires wires(&buzzer);
+Wires<> wires(&buzzer);
+Tempo tempo(&timer, &buzzer);
 IDriver *drivers[] = { (IDriver*) &timer,
+                       (IDriver*) &displays,
+                       (IDriver*) &i2c,
                        (IDriver*) &buzzer,
                        (IDriver*) &button,
                        (IDriver*) &wires,
+                       (IDriver*) &tempo,
                      };
 
 ESP8266WebServer server(80);
@@ -101,6 +142,13 @@ MAIN_STATES stateMain = SELECT_GAME;
 // Total time that students get as default value in minutes (50 minutes).
 uint8_t totalTimeDefault = 50;
 
+// Press of the hold that adds minutes and the time before it, a hold that becomes a long press keeps that time.
+uint64_t holdPressed = 0;
+uint8_t holdTime = 50;
+
+// Command that is received on the serial port, a line like "seed 1A2B3C4D" replays the puzzle of a seed.
+String serialCommand = "";
+
 /**
  * @brief Arduino Setup functie.
  * Initialiseert Seriële poort, EEPROM (voor wachtwoord), drivers en de webserver.
@@ -109,6 +157,10 @@ void setup() {
   Serial.begin(115200);
   Serial.println("\nStarting HackTheBom Firmware...");
 
+  // The channel comes from the hardware random generator. random() is not seeded, so it reads the hardware
+  // random generator as well and every digit of the password stays hardware random.
+  channel = 1 + ESP.random() % 12;
+
   /* Create a random number that will be used as Wi-Fi password. This number
    * will be stored in the EEPROM of the ESP8622.
    */ 
@@ -147,6 +199,10 @@ void setup() {
   server.on("/", handleRoot);
   server.on("/admin", handleAdmin);
   server.on("/code", handleCode);
+  server.on("/stats", handleStats);
+#ifdef HTB_DEBUG_THROUGHPUT
+  server.on("/throughput", handleThroughput);
+#endif
   server.onNotFound(handleNotFound);
   server.begin();
 
@@ -169,17 +225,20 @@ void loop() {
   for ( IDriver *driver: drivers ) { // Call the loop functions of the drivers.
       driver->loop(millis());
   }
+  handleSerial();
   
   // Implementation of the FSM by using a switch statement.
+  ButtonGesture gesture = button.getGesture();
   switch (stateMain) {
     case SELECT_GAME:
-      if ( button.isPressed() ) { // Wissel tussen Game 1 en Game 2
+      if ( gesture == GESTURE_CLICK ) { // Wissel tussen Game 1 en Game 2
         GAME_SELECTION = (GAME_SELECTION+1) % 2;
         timer.showGameSelection(GAME_SELECTION+1);
         printf("GAME: %d\n", GAME_SELECTION);
       }
 
-      if ( button.isLongPressed() ) { // Bevestig game keuze
+      if ( gesture == GESTURE_LONG_PRESS ) { // Bevestig game keuze
+        button.cancelGesture(); // Het vasthouden telt niet door in de tijd
         timer.showTime(totalTimeDefault, 0);
         stateMain = SELECT_TIME;
         buzzer.beep();
@@ -187,12 +246,30 @@ void loop() {
     break;
 
     case SELECT_TIME:
-      if ( button.isPressed() ) { // Verhoog tijd in stappen van 5 minuten
+      if ( gesture == GESTURE_CLICK ) { // Verhoog tijd in stappen van 5 minuten
         totalTimeDefault = (totalTimeDefault + 5) % 100;
         timer.showTime(totalTimeDefault, 0);
       }
 
-      if ( button.isLongPressed() ) { // Bevestig tijd
+      if ( gesture == GESTURE_REPEAT ) { // Vasthouden verhoogt de tijd per minuut, steeds sneller
+        if ( button.getChanged() != holdPressed ) { // Eerste herhaling van deze keer vasthouden
+          holdPressed = button.getChanged();
+          holdTime = totalTimeDefault;
+        }
+        totalTimeDefault = (totalTimeDefault + 1) % 100;
+        timer.showTime(totalTimeDefault, 0);
+      }
+
+      if ( gesture == GESTURE_TRIPLE_CLICK ) { // Terug naar de game keuze
+        timer.showGameSelection(GAME_SELECTION+1);
+        stateMain = SELECT_GAME;
+      }
+
+      if ( gesture == GESTURE_LONG_PRESS ) { // Bevestig tijd
+        if ( button.getChanged() == holdPressed ) { // De minuten van dit vasthouden tellen niet mee
+          totalTimeDefault = holdTime;
+        }
+        button.cancelGesture();
         timer.showTime(totalTimeDefault, 0);
         stateMain = READY;
         timer.blink(false);
@@ -201,10 +278,11 @@ void loop() {
     break;
 
     case READY:
-      if ( button.isPressed() ) { // START HET SPEL
+      if ( gesture == GESTURE_CLICK ) { // START HET SPEL
         stateMain = GAME_1; // Default
         timer.enterCountdown(totalTimeDefault);
         buzzer.startTicking();
+        tempo.start(GAME_SELECTION == 0 ? &TEMPO_GAME_1 : &TEMPO_GAME_2);
         wires.setup(); // Reset the game
 
         // Print the name of the device and the password.
@@ -220,6 +298,7 @@ void loop() {
     break;
 
     case GAME_1: // Draden spel (Minor Game)
+     tempo.setMistakes(wires.getMistakes());
      if ( wires.isWin() ) {
       stateMain = WIN;
       buzzer.startWin();
@@ -231,6 +310,7 @@ void loop() {
     break;
 
     case GAME_2: // Introduction, year 1 Game
+    tempo.setMistakes(webDefusingCodeTrials);
     if ( webDefusingCode.equals("BC84") ) { // Hardcoded!
       stateMain = WIN;
       buzzer.startWin();
@@ -243,11 +323,14 @@ void loop() {
     break;
 
     case WIN:
+      tempo.stop();
       timer.showYeah();
       stateMain = END;
     break;
 
     case LOSE:
+      tempo.stop();
+      buzzer.playSample(&SAMPLE_EXPLOSION); // The alarm is heard after the explosion
       timer.showLose();
       stateMain = END;
     break;
@@ -280,10 +363,7 @@ void handleRoot() {
     server.send(200, "text/html", index_html_2);
     webDefusingCode = server.arg("code");
     if ( !webDefusingCode.equals("") ) {
-      webDefusingCodeTrials++;
-      if ( webDefusingCodeTrials > 0 ) {
-        buzzer.startTicking(300); // double speed
-      }
+      webDefusingCodeTrials++; // The tempo ticks faster with every trial
     }
     printf("webDefusingCode: %s\n", webDefusingCode.c_str());
 
@@ -302,6 +382,36 @@ void handleAdmin() {
   server.send(200, "text/html", admin_html);
 }
 
+/**
+ * Handles the commands of the serial port, only the teacher with a cable to the bomb can give them. The command
+ * "seed <hex>" lets the next game replay the puzzle of the seed, the seed of a game is printed on the serial
+ * port. It is only accepted before the game has started. The characters are read without waiting.
+ *
+ * @param None
+ * @return None
+ */
+void handleSerial() {
+  while ( Serial.available() > 0 ) {
+    char c = Serial.read();
+    if ( c != '\n' && c != '\r' ) {
+      if ( serialCommand.length() < 32 ) {
+        serialCommand += c;
+      }
+      continue;
+    }
+
+    if ( serialCommand.startsWith("seed ") ) {
+      if ( stateMain != GAME_1 && stateMain != GAME_2 ) {
+        wires.setSeed(strtoul(serialCommand.c_str() + 5, NULL, 16));
+        printf("Replay seed: %08X\n", (unsigned int) wires.getSeed());
+      } else {
+        printf("Replay seed is not accepted during a game\n");
+      }
+    }
+    serialCommand = "";
+  }
+}
+
 /**
  * Handles the code webpage http://<ipaddress>/code.
  *
@@ -314,6 +424,119 @@ void handleCode() {
   server.send(200, "text/html", html);
 }
 
+#ifdef HTB_DEBUG_THROUGHPUT
+/**
+ * Handles the throughput webpage http://<ipaddress>/throughput?adc=<ms> of a debug build. It sends
+ * THROUGHPUT_BYTES to the client while the drivers loop between the chunks, with the ADC of wire 1 converted
+ * every <ms> (default ANALOG_INTERVAL, limited to THROUGHPUT_ADC_MIN - THROUGHPUT_ADC_MAX). The time of the
+ * transfer is shown on /stats. Compare adc=20, the rate of the conversions before the low rate sampling, with
+ * the default. The state machine of the game does not run during the transfer, so it is refused in a game.
+ *
+ * @param None
+ * @return None
+ */
+void handleThroughput() {
+  if ( stateMain == GAME_1 || stateMain == GAME_2 ) {
+    server.send(409, "text/plain", "Not during a game");
+    return;
+  }
+
+  long requested = (server.hasArg("adc") ? server.arg("adc").toInt() : ANALOG_INTERVAL);
+  AnalogInput* adc = wires.getInput()->getAnalog();
+  uint16_t interval = adc->getInterval();
+  throughputInterval = (requested < THROUGHPUT_ADC_MIN ? THROUGHPUT_ADC_MIN : (requested > THROUGHPUT_ADC_MAX ? THROUGHPUT_ADC_MAX : requested));
+  adc->setInterval(throughputInterval);
+
+  uint8_t chunk[THROUGHPUT_CHUNK];
+  memset(chunk, 'H', sizeof(chunk));
+  server.setContentLength(THROUGHPUT_BYTES);
+  server.send(200, "application/octet-stream", "");
+  uint32_t begin = millis();
+  for ( uint32_t sent=0; sent < THROUGHPUT_BYTES; sent += THROUGHPUT_CHUNK ) {
+    server.client().write(chunk, THROUGHPUT_CHUNK);
+    for ( IDriver *driver: drivers ) {
+      driver->loop(millis());
+    }
+  }
+  uint32_t duration = millis() - begin;
+  throughputKbps = (duration > 0 ? (uint32_t) ((uint64_t) THROUGHPUT_BYTES * 8 / duration) : 0);
+
+  adc->setInterval(interval);
+  printf("Throughput with ADC every %u ms: %u kbit/s\n", (unsigned int) throughputInterval, (unsigned int) throughputKbps);
+}
+#endif
+
+/**
+ * Handles the statistics webpage http://<ipaddress>/stats. It shows the performance counters of the
+ * drivers as plain text.
+ *
+ * @param None
+ * @return None
+ */
+void handleStats() {
+  String message = "HackTheBom statistics\n\n";
+  message += "displays.total: ";
+  message += displays.getTotal();
+  message += "\ndisplays.i2c.bytes: ";
+  message += displays.getBytes();
+  message += "\ndisplay.i2c.bytes: ";
+  message += timer.getDisplay()->getBytes();
+  message += "\ndisplay.i2c.bytesPerMinute: ";
+  message += timer.getDisplay()->getBytesPerMinute();
+  message += "\ni2c.completed: ";
+  message += i2c.getCompleted();
+  message += "\ni2c.dropped: ";
+  message += i2c.getDropped();
+  message += "\ni2c.errors: ";
+  message += i2c.getErrors();
+  message += "\ni2c.nacks: ";
+  message += i2c.getNacks();
+  message += "\ni2c.retries: ";
+  message += i2c.getRetries();
+  message += "\ni2c.timeouts: ";
+  message += i2c.getTimeouts();
+  message += "\ni2c.recoveries: ";
+  message += i2c.getRecoveries();
+  message += "\ni2c.queueMax: ";
+  message += i2c.getCountMax();
+  message += "\ni2c.latencyAverageUs: ";
+  message += i2c.getLatencyAverage();
+  message += "\ni2c.latencyMaxUs: ";
+  message += i2c.getLatencyMax();
+  message += "\ni2c.transactionMaxUs: ";
+  message += i2c.getDurationMax();
+  message += "\nbuzzer.preemptions: ";
+  message += buzzer.getMixer()->getPreemptions();
+  message += "\nbuzzer.resumes: ";
+  message += buzzer.getMixer()->getResumes();
+  message += "\nbuzzer.pcm.samples: ";
+  message += buzzer.getPcm()->getSamples();
+  message += "\nbuzzer.pcm.underruns: ";
+  message += buzzer.getPcm()->getUnderruns();
+  message += "\nbuzzer.pcm.loadPercent: ";
+  message += String(buzzer.getPcm()->getLoad(millis()) / 100.0, 2);
+#ifdef HTB_DEBUG_THROUGHPUT
+  message += "\nthroughput.adcIntervalMs: ";
+  message += throughputInterval;
+  message += "\nthroughput.kbitPerSecond: ";
+  message += throughputKbps;
+#endif
+  message += "\nwires.sampleCycles: ";
+  message += wires.getInput()->getSampleCycles();
+  message += "\nwires.adc.reads: ";
+  message += wires.getInput()->getAnalog()->getReads();
+  message += "\nwires.adc.cycles: ";
+  message += wires.getInput()->getAnalog()->getCycles();
+  message += "\nwires.edges: ";
+  message += wires.getInput()->getEdges();
+  message += "\nwires.cutLatencyLastMs: ";
+  message += wires.getLatencyLast();
+  message += "\nwires.cutLatencyMaxMs: ";
+  message += wires.getLatencyMax();
+  message += "\n";
+  server.send(200, "text/plain", message);
+}
+
 /**
  * Handles when a route does not exist.
  *
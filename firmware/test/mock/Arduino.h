@@ -0,0 +1,392 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/mock/Arduino.h
+ * @author     : Maurice Snoeren (MS)
+ * @description: Minimal Arduino/ESP8266 mock for the native test environment. It
+ *               provides a simulated clock, GPIO levels, the ADC value and the PWM
+ *               output so the drivers can be tested and benchmarked on the host.
+ *               Pin numbers are the real GPIO numbers of the D1 mini.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Timer1 and the GPIO set and clear registers.
+ *               19-10-2026 (MS): Sigma-delta modulator and the cycle counter.
+ *               19-10-2026 (MS): GPIO interrupts, a level change by digitalWrite calls them.
+ *               19-10-2026 (MS): GPIO input registers GPI and GP16I.
+ *               19-10-2026 (MS): A level change by GPOS and GPOC calls the GPIO interrupts.
+ *               19-10-2026 (MS): The hardware random generator ESP.random().
+ * @todo       :
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// D1 mini pin mapping (GPIO numbers).
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define A0 17
+
+#define LOW          0x0
+#define HIGH         0x1
+#define INPUT        0x00
+#define OUTPUT       0x01
+#define INPUT_PULLUP 0x02
+#define OUTPUT_OPEN_DRAIN 0x03
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define digitalPinToInterrupt(p) (p)
+
+#define IRAM_ATTR
+
+// Timer1 of the ESP8266, with TIM_DIV16 it counts on 5 MHz.
+#define TIM_DIV1   0
+#define TIM_DIV16  1
+#define TIM_DIV256 3
+#define TIM_EDGE   0
+#define TIM_LEVEL  1
+#define TIM_SINGLE 0
+#define TIM_LOOP   1
+
+typedef void (*timercallback)(void);
+typedef void (*voidFuncPtr)(void);
+
+#define PROGMEM
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define memcpy_P             memcpy
+
+/* Namespace: mock
+ * State of the simulated board. Tests set the inputs and read the outputs directly.
+ */
+namespace mock {
+   inline uint64_t now = 0;            // Simulated millis()
+   inline uint64_t nowMicros = 0;      // Sub-millisecond part in microseconds
+   inline uint8_t pinModes[18];        // Mode per GPIO
+   inline uint8_t pinLevels[18];       // Input/output level per GPIO
+   inline uint16_t adcValue = 0;       // Value returned by analogRead(A0)
+   inline uint32_t adcReads = 0;       // Total analogRead() calls
+   inline uint32_t gpioReads = 0;      // Total reads of a GPIO input: digitalRead(), GPI and GP16I
+   inline uint32_t pwmFrequency = 1000;// Last analogWriteFreq()
+   inline uint32_t pwmValue[18];       // Last analogWrite() per GPIO
+   inline uint32_t randomState = 1;    // Deterministic random()
+   inline uint32_t hardwareRandom = 0x2545F491; // Value of the next ESP.random()
+   inline timercallback timer1Callback = NULL; // Interrupt routine of timer1
+   inline bool timer1Enabled = false;  // Timer1 is running
+   inline uint32_t timer1Ticks = 0;    // Last timer1_write()
+   inline uint32_t timer1Writes = 0;   // Total timer1_write() calls
+   inline int8_t sigmaDeltaPin = -1;   // Pin of the sigma-delta modulator, -1 when it is detached
+   inline uint32_t sigmaDeltaWrites = 0; // Total samples written to GPSD
+   inline uint32_t cycles = 0;         // Extra CPU cycles, ESP.getCycleCount() adds cyclesPerRead on every read
+   inline uint32_t cyclesPerRead = 0;  // Simulated cost between two reads of the cycle counter
+   inline voidFuncPtr isr[18];         // GPIO interrupt routine per pin
+   inline uint8_t isrMode[18];         // RISING, FALLING or CHANGE per pin
+   inline bool isrEnabled = true;      // Interrupts are enabled, see noInterrupts()
+
+   /* Reset the simulated board to power on state.
+    *
+    * @param None
+    * @return None
+    */
+   inline void reset() {
+      now = 0;
+      nowMicros = 0;
+      adcValue = 0;
+      adcReads = 0;
+      gpioReads = 0;
+      pwmFrequency = 1000;
+      randomState = 1;
+      hardwareRandom = 0x2545F491;
+      timer1Callback = NULL;
+      timer1Enabled = false;
+      timer1Ticks = 0;
+      timer1Writes = 0;
+      sigmaDeltaPin = -1;
+      sigmaDeltaWrites = 0;
+      cycles = 0;
+      cyclesPerRead = 0;
+      isrEnabled = true;
+      for ( uint8_t i=0; i < 18; i++ ) {
+         isr[i] = NULL;
+         isrMode[i] = 0;
+         pinModes[i] = INPUT;
+         pinLevels[i] = HIGH;
+         pwmValue[i] = 0;
+      }
+   }
+
+   /* Advance the simulated clock.
+    *
+    * @param ms: milliseconds to advance
+    * @return None
+    */
+   inline void advance(uint64_t ms) {
+      now += ms;
+   }
+
+   /* Fire the interrupt of timer1 the given times, as if the timer counted down.
+    *
+    * @param times: total interrupts
+    * @return None
+    */
+   inline void timer1Fire(uint32_t times) {
+      for ( uint32_t i=0; i < times && timer1Enabled && timer1Callback != NULL; i++ ) {
+         timer1Callback();
+      }
+   }
+
+   /* Change the level of a GPIO and call its interrupt on a matching edge, like an external circuit would see it.
+    *
+    * @param pin: the GPIO
+    * @param level: HIGH or LOW
+    * @return None
+    */
+   inline void setLevel(uint8_t pin, uint8_t level) {
+      uint8_t previous = pinLevels[pin];
+      pinLevels[pin] = level;
+      if ( level != previous && isr[pin] != NULL ) {
+         uint8_t edge = (level == HIGH ? 0x01 : 0x02); // RISING or FALLING
+         if ( isrMode[pin] & edge ) {
+            isr[pin]();
+         }
+      }
+   }
+
+   /* Struct: GpioRegister
+    * A write only register that sets the level of the GPIOs of the bits in the mask, like GPOS and GPOC.
+    */
+   struct GpioRegister {
+      uint8_t level;
+
+      GpioRegister& operator=(uint32_t mask) {
+         for ( uint8_t i=0; i < 16; i++ ) {
+            if ( mask & (1UL << i) ) {
+               setLevel(i, level);
+            }
+         }
+         return *this;
+      }
+   };
+
+   /* Struct: GpioInput
+    * A read only register with the input levels of the GPIOs from the first GPIO on, like GPI and GP16I.
+    */
+   struct GpioInput {
+      uint8_t first;
+      uint8_t count;
+
+      operator uint32_t() const {
+         gpioReads++;
+         uint32_t levels = 0;
+         for ( uint8_t i=0; i < count; i++ ) {
+            levels |= (uint32_t) (pinLevels[first + i] & 1) << i;
+         }
+         return levels;
+      }
+   };
+}
+
+// GPIO output set and clear registers of GPIO0-15.
+inline mock::GpioRegister GPOS = { HIGH };
+inline mock::GpioRegister GPOC = { LOW };
+
+// GPIO input registers: GPIO0-15 and GPIO16 in the RTC block.
+inline const mock::GpioInput GPI = { 0, 16 };
+inline const mock::GpioInput GP16I = { 16, 1 };
+
+/* Struct: SigmaDeltaRegister
+ * The sigma-delta register GPSD: bit 0-7 is the duty, bit 8-15 the prescaler and bit 16 enables it.
+ */
+struct SigmaDeltaRegister {
+   uint32_t value = 0;
+
+   operator uint32_t() const {
+      return this->value;
+   }
+
+   SigmaDeltaRegister& operator=(uint32_t value) {
+      this->value = value;
+      mock::sigmaDeltaWrites++;
+      return *this;
+   }
+};
+inline SigmaDeltaRegister GPSD;
+
+inline uint32_t sigmaDeltaSetup(uint8_t, uint32_t freq) {
+   GPSD.value = (1UL << 16) | (((80000000UL / 256 / freq) - 1) << 8);
+   return freq;
+}
+
+inline void sigmaDeltaAttachPin(uint8_t pin, uint8_t = 0) {
+   mock::sigmaDeltaPin = pin;
+}
+
+inline void sigmaDeltaDetachPin(uint8_t) {
+   mock::sigmaDeltaPin = -1;
+}
+
+/* Class: EspClass
+ * The ESP object with the cycle counter of the CPU on 80 MHz.
+ */
+class EspClass {
+public:
+   uint32_t getCycleCount() {
+      mock::cycles += mock::cyclesPerRead;
+      return (uint32_t) ((mock::now * 1000 + mock::nowMicros) * 80) + mock::cycles;
+   }
+
+   uint8_t getCpuFreqMHz() {
+      return 80;
+   }
+
+   // The hardware random generator, every read returns another value.
+   uint32_t random() {
+      uint32_t value = mock::hardwareRandom;
+      mock::hardwareRandom = mock::hardwareRandom * 747796405 + 2891336453;
+      return value;
+   }
+};
+inline EspClass ESP;
+
+inline void timer1_attachInterrupt(timercallback callback) {
+   mock::timer1Callback = callback;
+}
+
+inline void timer1_enable(uint8_t, uint8_t, uint8_t) {
+   mock::timer1Enabled = true;
+}
+
+inline void timer1_disable() {
+   mock::timer1Enabled = false;
+}
+
+inline void timer1_write(uint32_t ticks) {
+   mock::timer1Ticks = ticks;
+   mock::timer1Writes++;
+}
+
+inline unsigned long millis() {
+   return (unsigned long) mock::now;
+}
+
+inline unsigned long micros() {
+   return (unsigned long) (mock::now * 1000 + mock::nowMicros);
+}
+
+inline void delay(unsigned long ms) {
+   mock::now += ms;
+}
+
+inline void delayMicroseconds(unsigned int us) {
+   mock::nowMicros += us;
+   mock::now += mock::nowMicros / 1000;
+   mock::nowMicros %= 1000;
+}
+
+inline void yield() {
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+   mock::pinModes[pin] = mode;
+}
+
+inline int digitalRead(uint8_t pin) {
+   mock::gpioReads++;
+   return mock::pinLevels[pin];
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+   mock::setLevel(pin, value);
+}
+
+inline void attachInterrupt(uint8_t pin, voidFuncPtr isr, int mode) {
+   mock::isr[pin] = isr;
+   mock::isrMode[pin] = mode;
+}
+
+inline void detachInterrupt(uint8_t pin) {
+   mock::isr[pin] = NULL;
+}
+
+inline void noInterrupts() {
+   mock::isrEnabled = false;
+}
+
+inline void interrupts() {
+   mock::isrEnabled = true;
+}
+
+inline int analogRead(uint8_t) {
+   mock::adcReads++;
+   return mock::adcValue;
+}
+
+inline void analogWrite(uint8_t pin, int value) {
+   mock::pwmValue[pin] = value;
+}
+
+inline void analogWriteFreq(uint32_t freq) {
+   mock::pwmFrequency = freq;
+}
+
+inline long random(long max) {
+   mock::randomState = mock::randomState * 1103515245 + 12345;
+   return max > 0 ? (long) ((mock::randomState >> 8) % (uint32_t) max) : 0;
+}
+
+inline long random(long min, long max) {
+   return min + random(max - min);
+}
+
+inline void randomSeed(unsigned long seed) {
+   mock::randomState = seed;
+}
+
+/* Class: HardwareSerial
+ * Serial port that writes to stdout when verbose, otherwise it is silent.
+ */
+class HardwareSerial {
+public:
+   bool verbose = false;
+
+   void begin(unsigned long) {
+   }
+
+   void print(const char* s) {
+      if ( this->verbose ) fputs(s, stdout);
+   }
+
+   void println(const char* s = "") {
+      if ( this->verbose ) puts(s);
+   }
+
+   template <typename... Args>
+   void printf(const char* format, Args... args) {
+      if ( this->verbose ) ::printf(format, args...);
+   }
+};
+
+inline HardwareSerial Serial;
@@ -0,0 +1,120 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/mock/HT16K33.h
+ * @author     : Maurice Snoeren (MS)
+ * @description: Stand-in for the robtillaart/HT16K33 library in the native test
+ *               environment. It implements the part of the API the firmware uses
+ *               and writes one display position per transaction over the mocked
+ *               Wire, like the real library does without its cache.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SEG_NONE 0x00
+#define SEG_A    0x01
+#define SEG_B    0x02
+#define SEG_C    0x04
+#define SEG_D    0x08
+#define SEG_E    0x10
+#define SEG_F    0x20
+#define SEG_G    0x40
+#define SEG_DP   0x80
+
+/* Class: HT16K33
+ * Mock of the 4 digit 7-segment HT16K33 driver (digits on position 0, 1, 3 and 4, colon on 2).
+ */
+class HT16K33 {
+private:
+   uint8_t address;
+   TwoWire* wire;
+
+   void writeCmd(uint8_t cmd) {
+      this->wire->beginTransmission(this->address);
+      this->wire->write(cmd);
+      this->wire->endTransmission();
+   }
+
+   void writePos(uint8_t pos, uint8_t mask) {
+      this->wire->beginTransmission(this->address);
+      this->wire->write(pos * 2);
+      this->wire->write(mask);
+      this->wire->endTransmission();
+   }
+
+public:
+   static constexpr uint8_t charmap[] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07,
+                                          0x7F, 0x6F, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71,
+                                          0x00, 0x40 };
+
+   HT16K33(uint8_t address, TwoWire* wire = &Wire): address(address), wire(wire) {
+   }
+
+   bool begin() {
+      this->writeCmd(0x21); // Oscillator on
+      return true;
+   }
+
+   void displayOn() {
+      this->writeCmd(0x81);
+   }
+
+   void displayOff() {
+      this->writeCmd(0x80);
+   }
+
+   void setBrightness(uint8_t value) {
+      this->writeCmd(0xE0 | (value & 0x0F));
+   }
+
+   void setBlink(uint8_t value) {
+      this->writeCmd(0x81 | ((value & 0x03) << 1));
+   }
+
+   void setDigits(uint8_t) {
+   }
+
+   void displayColon(uint8_t on) {
+      this->writePos(2, on ? 2 : 0);
+   }
+
+   void displayRaw(uint8_t* array, bool colon = false) {
+      this->writePos(0, array[0]);
+      this->writePos(1, array[1]);
+      this->writePos(3, array[2]);
+      this->writePos(4, array[3]);
+      this->displayColon(colon);
+   }
+
+   void display(uint8_t* array) {
+      uint8_t x[4];
+      for ( uint8_t i=0; i < 4; i++ ) {
+         x[i] = charmap[array[i] < sizeof(charmap) ? array[i] : 16];
+      }
+      this->displayRaw(x, false);
+   }
+
+   bool displayTime(uint8_t left, uint8_t right, bool colon = true, bool lz = true) {
+      uint8_t x[4] = { charmap[left / 10], charmap[left % 10], charmap[right / 10], charmap[right % 10] };
+      if ( !lz && left < 10 ) {
+         x[0] = 0;
+      }
+      this->displayRaw(x, colon);
+      return true;
+   }
+};
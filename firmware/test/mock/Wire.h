@@ -0,0 +1,130 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/mock/Wire.h
+ * @author     : Maurice Snoeren (MS)
+ * @description: I2C mock for the native test environment. Every transaction is
+ *               counted and the writes are decoded as HT16K33 display RAM writes,
+ *               so the tests can check what is on the display and how many bytes
+ *               went over the bus. A transaction takes the simulated bus time of its bytes.
+ *               Failures of the bus (NACK or hung) can be injected for a number of transactions.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <Arduino.h>
+
+/* Class: TwoWire
+ * Records the I2C traffic and emulates the display RAM of HT16K33 chips on 0x70-0x77.
+ */
+class TwoWire {
+private:
+   uint8_t address;
+   uint8_t buffer[32];
+   uint8_t length;
+
+public:
+   uint32_t clock = 100000;
+   uint32_t transactions = 0;   // Total transactions (endTransmission calls)
+   uint32_t bytes = 0;          // Total bytes on the bus, including the address byte
+   uint8_t ram[8][16];          // Display RAM of HT16K33 0x70-0x77
+   uint8_t lastCommand[8];      // Last command byte (>= 0x20) per HT16K33
+   uint32_t begins = 0;         // Total begin() calls
+   uint32_t stretchLimit = 0;   // Last setClockStretchLimit() in us
+   uint8_t failResult = 0;      // Result of endTransmission() while failing, 2/3 is NACK, 4 is a hung bus
+   uint32_t failCount = 0;      // Total next transactions that fail
+   uint32_t failUs = 0;         // Time in us that a failing transaction takes
+
+   TwoWire() {
+      this->reset();
+   }
+
+   void reset() {
+      this->transactions = 0;
+      this->bytes = 0;
+      this->begins = 0;
+      this->failResult = 0;
+      this->failCount = 0;
+      this->failUs = 0;
+      this->length = 0;
+      memset(this->ram, 0, sizeof(this->ram));
+      memset(this->lastCommand, 0, sizeof(this->lastCommand));
+   }
+
+   void begin() {
+      this->begins++;
+   }
+
+   void setClockStretchLimit(uint32_t limit) {
+      this->stretchLimit = limit;
+   }
+
+   void setClock(uint32_t c) {
+      this->clock = c;
+   }
+
+   void beginTransmission(uint8_t a) {
+      this->address = a;
+      this->length = 0;
+   }
+
+   size_t write(uint8_t b) {
+      if ( this->length < sizeof(this->buffer) ) {
+         this->buffer[this->length++] = b;
+         return 1;
+      }
+      return 0;
+   }
+
+   uint8_t endTransmission(bool = true) {
+      this->transactions++;
+      if ( this->failCount > 0 ) {
+         this->failCount--;
+         this->length = 0;
+         delayMicroseconds(this->failUs);
+         return this->failResult;
+      }
+
+      this->bytes += 1 + this->length;
+      delayMicroseconds((1 + this->length) * 9 * 1000000UL / this->clock); // 9 clocks per byte
+
+      if ( this->address >= 0x70 && this->address <= 0x77 && this->length > 0 ) {
+         uint8_t chip = this->address - 0x70;
+         if ( this->buffer[0] < 0x10 ) { // Display RAM pointer followed by data (auto increment)
+            for ( uint8_t i=1; i < this->length; i++ ) {
+               this->ram[chip][(this->buffer[0] + i - 1) & 0x0F] = this->buffer[i];
+            }
+         } else {
+            this->lastCommand[chip] = this->buffer[0];
+         }
+      }
+      this->length = 0;
+      return 0;
+   }
+
+   uint8_t requestFrom(uint8_t, uint8_t) {
+      return 0;
+   }
+
+   int available() {
+      return 0;
+   }
+
+   int read() {
+      return -1;
+   }
+};
+
+inline TwoWire Wire;
@@ -0,0 +1,72 @@
+#pragma once
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/mock/bench.h
+ * @author     : Maurice Snoeren (MS)
+ * @description: Microbenchmark helper for the native tests. It measures the host
+ *               time per call of a driver function and the simulated time that the
+ *               call blocked (delay() advances the simulated clock).
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <chrono>
+#include <stdio.h>
+
+#include <Arduino.h>
+#include <unity.h>
+
+/* Struct: BenchResult
+ * Result of a benchmark run.
+ */
+struct BenchResult {
+   double nsPerCall;       // Average host time per call in nanoseconds
+   uint64_t maxBlockedMs;  // Worst case simulated time spent inside one call
+};
+
+/* Run the function f the given times and measure the cost per call. Before every call the
+ * simulated clock is advanced with stepMs, so time based code takes its normal path.
+ *
+ * @param name: name that is reported in the test output
+ * @param iterations: total calls of f
+ * @param stepMs: simulated milliseconds between two calls
+ * @param f: function to benchmark, it gets the iteration number
+ * @return The benchmark result.
+ */
+template <typename F>
+BenchResult bench(const char* name, uint32_t iterations, uint32_t stepMs, F f) {
+   BenchResult result = { 0, 0 };
+
+   auto start = std::chrono::steady_clock::now();
+   for ( uint32_t i=0; i < iterations; i++ ) {
+      mock::now += stepMs;
+      uint64_t before = mock::now;
+      f(i);
+      uint64_t blocked = mock::now - before;
+      if ( blocked > result.maxBlockedMs ) {
+         result.maxBlockedMs = blocked;
+      }
+   }
+   auto end = std::chrono::steady_clock::now();
+
+   result.nsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+
+   char message[128];
+   snprintf(message, sizeof(message), "BENCH %s: %.1f ns/call, max blocked %llu ms",
+            name, result.nsPerCall, (unsigned long long) result.maxBlockedMs);
+   TEST_MESSAGE(message);
+
+   return result;
+}
@@ -0,0 +1,130 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_animation/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the keyframe animations.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <timer.hpp>
+
+I2CQueue i2c;
+DisplayManager displays(&i2c);
+Timer timer(displays.get(0));
+
+// Run the timer for the given simulated time, 1 ms per pass.
+void run(uint32_t ms) {
+   for ( uint32_t i=0; i < ms; i++ ) {
+      mock::advance(1);
+      timer.loop(mock::now);
+      displays.loop(mock::now);
+      i2c.loop(mock::now);
+   }
+}
+
+void setUp() {
+   mock::reset();
+   Wire.reset();
+   i2c.reset();
+   displays = DisplayManager(&i2c);
+   displays.setup();
+   timer = Timer(displays.get(0));
+   timer.setup();
+   run(10);
+}
+
+void tearDown() {
+}
+
+void test_keyframe_deadlines() {
+   Animator animator;
+   Keyframe k;
+   animator.play(&ANIMATION_SPINNER, 1000);
+
+   TEST_ASSERT_EQUAL(ANIMATION_IDLE, animator.loop(999, &k));
+   TEST_ASSERT_EQUAL(ANIMATION_FRAME, animator.loop(1000, &k));
+   TEST_ASSERT_EQUAL_HEX8(FONT_A, k.text.digits[0]);
+   TEST_ASSERT_EQUAL(ANIMATION_IDLE, animator.loop(1059, &k));
+   TEST_ASSERT_EQUAL(ANIMATION_FRAME, animator.loop(1060, &k));
+   TEST_ASSERT_EQUAL_HEX8(FONT_A, k.text.digits[1]);
+
+   // Late loop skips the missed keyframes, frame 4 starts at 1240.
+   TEST_ASSERT_EQUAL(ANIMATION_FRAME, animator.loop(1250, &k));
+   TEST_ASSERT_EQUAL_HEX8(FONT_B, k.text.digits[3]);
+   TEST_ASSERT_EQUAL(ANIMATION_IDLE, animator.loop(1299, &k));
+   TEST_ASSERT_EQUAL(ANIMATION_FRAME, animator.loop(1300, &k));
+}
+
+void test_spinner_on_display() {
+   timer.showSpinner();
+   run(5);
+   TEST_ASSERT_EQUAL_HEX8(FONT_A, Wire.ram[0][0]);
+   run(60);
+   TEST_ASSERT_EQUAL_HEX8(0x00, Wire.ram[0][0]);
+   TEST_ASSERT_EQUAL_HEX8(FONT_A, Wire.ram[0][2]);
+
+   timer.showTime(10, 0); // Stops the spinner
+   run(1000);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('1'), Wire.ram[0][0]);
+}
+
+void test_lose_fanfare_ends_with_lose() {
+   timer.showLose();
+   run(50);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('8'), Wire.ram[0][0]);
+   run(2000);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('L'), Wire.ram[0][0]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('E'), Wire.ram[0][8]);
+}
+
+void test_flash_in_last_minute() {
+   timer.setHighResolution(false); // Keep MM:SS in the last minute
+   timer.enterCountdown(2);
+   run(30 * 1000 + 900);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('1'), Wire.ram[0][2]); // No flash yet
+
+   run(30 * 1000); // 01:00 left at 60 s, 200 ms hidden at 60.8 s
+   TEST_ASSERT_EQUAL_HEX8(0x00, Wire.ram[0][2]);
+   run(200);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('0'), Wire.ram[0][2]);
+
+   run(60 * 1000); // Countdown finished, everything visible
+   TEST_ASSERT_TRUE(timer.isTimerZero());
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('0'), Wire.ram[0][8]);
+}
+
+void test_bench_loop_animation() {
+   timer.showSpinner();
+   BenchResult r = bench("Timer::loop spinner", 1000000, 1, [](uint32_t) {
+      timer.loop(mock::now);
+      displays.loop(mock::now);
+      i2c.reset();
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_keyframe_deadlines);
+   RUN_TEST(test_spinner_on_display);
+   RUN_TEST(test_lose_fanfare_ends_with_lose);
+   RUN_TEST(test_flash_in_last_minute);
+   RUN_TEST(test_bench_loop_animation);
+   return UNITY_END();
+}
@@ -0,0 +1,356 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_button/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the Button driver.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Bouncing contacts and a slow loop.
+ *               19-10-2026 (MS): Gestures of the button.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <button.hpp>
+
+Button button;
+
+void setUp() {
+   mock::reset();
+   button = Button();
+   button.setup();
+}
+
+void tearDown() {
+}
+
+// Run the loop of the button the given passes, 1 ms per pass.
+void run(uint32_t passes) {
+   for ( uint32_t i=0; i < passes; i++ ) {
+      mock::advance(1);
+      button.loop(mock::now);
+   }
+}
+
+// Run the loop of the button every period ms for the given time, like a loop that is blocked by the web server.
+void runSlow(uint32_t time, uint32_t period) {
+   for ( uint32_t t=0; t < time; t += period ) {
+      mock::advance(period);
+      button.loop(mock::now);
+   }
+}
+
+// Bounce the contacts: pulses of 1-5 ms, shorter than the settle time, before the level is stable.
+void bounce(uint8_t level) {
+   for ( uint8_t i=1; i <= 5; i++ ) {
+      digitalWrite(D3, level);
+      mock::advance(i);
+      digitalWrite(D3, level == LOW ? HIGH : LOW);
+      mock::advance(i);
+   }
+   digitalWrite(D3, level);
+}
+
+void test_short_glitch_is_ignored() {
+   digitalWrite(D3, LOW);
+   run(BUTTON_SETTLE - 1);
+   digitalWrite(D3, HIGH);
+   run(300);
+
+   TEST_ASSERT_FALSE(button.isPressed());
+   TEST_ASSERT_FALSE(button.isLongPressed());
+}
+
+void test_bouncing_press_is_one_press() {
+   bounce(LOW);
+   uint64_t pressed = mock::now;
+   run(200);
+   bounce(HIGH);
+   uint64_t released = mock::now;
+   run(200);
+
+   TEST_ASSERT_TRUE(button.isPressed());
+   TEST_ASSERT_FALSE(button.isPressed());
+   TEST_ASSERT_EQUAL((uint32_t) released, (uint32_t) button.getChanged()); // Last edge of the bouncing
+   TEST_ASSERT_LESS_THAN((uint32_t) released, (uint32_t) pressed);
+   TEST_ASSERT_EQUAL(22, button.getEdges()); // 5 pulses of bouncing and the stable edge, twice
+}
+
+void test_slow_loop_same_result() {
+   // Fast loop of 1 ms
+   bounce(LOW);
+   uint64_t pressed = mock::now;
+   run(100);
+   bounce(HIGH);
+   run(300);
+   uint64_t fast = button.getChanged() - pressed;
+   TEST_ASSERT_TRUE(button.isPressed());
+
+   // Loop that is blocked 200 ms, e.g. while a page is sent
+   bounce(LOW);
+   pressed = mock::now;
+   runSlow(100, 50);
+   bounce(HIGH);
+   runSlow(400, 200);
+   uint64_t slow = button.getChanged() - pressed;
+   TEST_ASSERT_TRUE(button.isPressed());
+
+   TEST_ASSERT_EQUAL((uint32_t) fast, (uint32_t) slow);
+}
+
+void test_click_between_two_loops() {
+   run(10);
+   bounce(LOW);
+   mock::advance(100);
+   bounce(HIGH);
+   mock::advance(100);
+   button.loop(mock::now); // The complete click happened during one blocked loop
+
+   TEST_ASSERT_TRUE(button.isPressed());
+   TEST_ASSERT_FALSE(button.isLongPressed());
+}
+
+void test_long_press_between_two_loops() {
+   run(10);
+   digitalWrite(D3, LOW);
+   mock::advance(2500);
+   digitalWrite(D3, HIGH);
+   mock::advance(100);
+   button.loop(mock::now);
+
+   TEST_ASSERT_TRUE(button.isLongPressed());
+   TEST_ASSERT_FALSE(button.isPressed());
+}
+
+void test_long_press_time_from_edge() {
+   digitalWrite(D3, LOW);
+   runSlow(1800, 300);
+   TEST_ASSERT_FALSE(button.isLongPressed());
+   runSlow(300, 300); // 2100 ms after the edge, although the press was accepted on the first slow loop
+   TEST_ASSERT_TRUE(button.isLongPressed());
+   digitalWrite(D3, HIGH);
+   run(100);
+}
+
+void test_settle_is_configurable() {
+   button.setSettle(100);
+   digitalWrite(D3, LOW);
+   run(60);
+   digitalWrite(D3, HIGH);
+   run(300);
+   TEST_ASSERT_FALSE(button.isPressed());
+
+   button.setSettle(10);
+   digitalWrite(D3, LOW);
+   run(20);
+   digitalWrite(D3, HIGH);
+   run(300);
+   TEST_ASSERT_TRUE(button.isPressed());
+}
+
+void test_lost_edges_resync() {
+   for ( uint8_t i=0; i < 2 * BUTTON_EDGES; i++ ) {
+      digitalWrite(D3, i % 2 ? HIGH : LOW);
+   }
+   digitalWrite(D3, LOW);
+   run(300);
+   digitalWrite(D3, HIGH);
+   run(300);
+   TEST_ASSERT_TRUE(button.isPressed());
+}
+
+void test_short_press_on_release() {
+   digitalWrite(D3, LOW);
+   run(300);
+   TEST_ASSERT_FALSE(button.isPressed()); // Only reported when released
+
+   digitalWrite(D3, HIGH);
+   run(300);
+   TEST_ASSERT_TRUE(button.isPressed());
+   TEST_ASSERT_FALSE(button.isPressed()); // Reported once
+   TEST_ASSERT_FALSE(button.isLongPressed());
+}
+
+void test_long_press() {
+   digitalWrite(D3, LOW);
+   run(1500);
+   TEST_ASSERT_FALSE(button.isLongPressed());
+
+   run(1000);
+   TEST_ASSERT_TRUE(button.isLongPressed());
+   TEST_ASSERT_FALSE(button.isLongPressed()); // Reported once while held
+
+   run(3000);
+   TEST_ASSERT_FALSE(button.isLongPressed());
+
+   digitalWrite(D3, HIGH);
+   run(300);
+   TEST_ASSERT_FALSE(button.isPressed()); // Long press is not also a short press
+}
+
+// Click the button: pressed for the given time and released.
+void click(uint32_t pressed, uint32_t released) {
+   digitalWrite(D3, LOW);
+   run(pressed);
+   digitalWrite(D3, HIGH);
+   run(released);
+}
+
+// Count the gestures that are stored.
+uint32_t count(ButtonGesture gesture) {
+   uint32_t total = 0;
+   ButtonGesture g;
+   while ( (g = button.getGesture()) != GESTURE_NONE ) {
+      total += (g == gesture ? 1 : 0);
+   }
+   return total;
+}
+
+void test_gesture_clicks() {
+   click(80, 400);
+   TEST_ASSERT_EQUAL(GESTURE_CLICK, button.getGesture());
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture());
+
+   click(80, 100);
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture()); // Waiting for a next click
+   click(80, 400);
+   TEST_ASSERT_EQUAL(GESTURE_DOUBLE_CLICK, button.getGesture());
+
+   click(80, 100);
+   click(80, 100);
+   click(80, 0);
+   run(BUTTON_SETTLE);
+   TEST_ASSERT_EQUAL(GESTURE_TRIPLE_CLICK, button.getGesture()); // At once after the release of the third click
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture());
+}
+
+void test_gesture_long_press_and_repeat() {
+   digitalWrite(D3, LOW);
+   run(GESTURE_HOLD - 1);
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture()); // The hold is timed from the edge of the press
+   run(1);
+   TEST_ASSERT_EQUAL(GESTURE_REPEAT, button.getGesture());
+
+   run(GESTURE_REPEAT_FIRST);
+   TEST_ASSERT_EQUAL(GESTURE_REPEAT, button.getGesture());
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture());
+
+   // The repeats get faster until the shortest interval
+   uint32_t first = 0;
+   for ( uint32_t i=0; i < 200; i++ ) {
+      run(1);
+      first += (button.getGesture() == GESTURE_REPEAT ? 1 : 0);
+   }
+   run(2000);
+   count(GESTURE_REPEAT);
+   uint32_t late = 0;
+   for ( uint32_t i=0; i < 200; i++ ) {
+      run(1);
+      late += (button.getGesture() == GESTURE_REPEAT ? 1 : 0);
+   }
+   TEST_ASSERT_LESS_THAN(late, first);
+   TEST_ASSERT_EQUAL(200 / GESTURE_REPEAT_MIN, late);
+
+   digitalWrite(D3, HIGH);
+   run(500);
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture()); // A hold is not a click
+}
+
+void test_gesture_long_press_once() {
+   digitalWrite(D3, LOW);
+   run(5000);
+   TEST_ASSERT_EQUAL(1, count(GESTURE_LONG_PRESS));
+   digitalWrite(D3, HIGH);
+   run(500);
+   TEST_ASSERT_EQUAL(0, count(GESTURE_CLICK));
+}
+
+void test_gesture_slow_loop_same_repeats() {
+   digitalWrite(D3, LOW);
+   uint32_t fast = 0;
+   for ( uint32_t i=0; i < 2000; i++ ) {
+      run(1);
+      fast += count(GESTURE_REPEAT);
+   }
+   digitalWrite(D3, HIGH);
+   run(500);
+
+   digitalWrite(D3, LOW);
+   uint32_t slow = 0;
+   for ( uint32_t i=0; i < 10; i++ ) {
+      runSlow(200, 200);
+      slow += count(GESTURE_REPEAT);
+   }
+   digitalWrite(D3, HIGH);
+   run(500);
+
+   TEST_ASSERT_GREATER_THAN(10, fast);
+   TEST_ASSERT_EQUAL(fast, slow);
+}
+
+void test_gesture_cancel() {
+   digitalWrite(D3, LOW);
+   run(2500);
+   button.cancelGesture();
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture());
+   run(1000);
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture()); // No repeats until released
+   digitalWrite(D3, HIGH);
+   run(500);
+   TEST_ASSERT_EQUAL(GESTURE_NONE, button.getGesture());
+
+   click(80, 400);
+   TEST_ASSERT_EQUAL(GESTURE_CLICK, button.getGesture());
+}
+
+void test_bench_idle_gesture() {
+   BenchResult r = bench("Button::loop idle", 1000000, 1, [](uint32_t) {
+      button.loop(mock::now);
+   });
+   TEST_ASSERT_EQUAL(0, r.maxBlockedMs);
+   TEST_ASSERT_LESS_THAN(100.0, r.nsPerCall);
+}
+
+void test_bench_loop() {
+   BenchResult r = bench("Button::loop", 1000000, 1, [](uint32_t i) {
+      digitalWrite(D3, (i / 5000) % 2 ? LOW : HIGH);
+      button.loop(mock::now);
+   });
+   TEST_ASSERT_EQUAL(0, r.maxBlockedMs);
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_short_glitch_is_ignored);
+   RUN_TEST(test_bouncing_press_is_one_press);
+   RUN_TEST(test_short_press_on_release);
+   RUN_TEST(test_slow_loop_same_result);
+   RUN_TEST(test_click_between_two_loops);
+   RUN_TEST(test_long_press_between_two_loops);
+   RUN_TEST(test_long_press_time_from_edge);
+   RUN_TEST(test_settle_is_configurable);
+   RUN_TEST(test_lost_edges_resync);
+   RUN_TEST(test_long_press);
+   RUN_TEST(test_gesture_clicks);
+   RUN_TEST(test_gesture_long_press_and_repeat);
+   RUN_TEST(test_gesture_long_press_once);
+   RUN_TEST(test_gesture_slow_loop_same_repeats);
+   RUN_TEST(test_gesture_cancel);
+   RUN_TEST(test_bench_idle_gesture);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
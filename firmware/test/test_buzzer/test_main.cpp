@@ -0,0 +1,361 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_buzzer/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the Buzzer driver and its sequencer.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): The tone is generated by timer1.
+ *               19-10-2026 (MS): Priorities of the mixer.
+ *               19-10-2026 (MS): Volume envelopes.
+ *               19-10-2026 (MS): The release of the shipped envelopes and a full scale step.
+ *               19-10-2026 (MS): The tone of on is played by the mixer.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <buzzer.hpp>
+
+Buzzer buzzer;
+
+// Run the buzzer loop for the given simulated time, 1 ms per pass.
+void run(uint32_t ms) {
+   for ( uint32_t i=0; i < ms; i++ ) {
+      mock::advance(1);
+      buzzer.loop(mock::now);
+   }
+}
+
+// Return whether the buzzer output is on with the given frequency.
+bool sounds(uint32_t f) {
+   return mock::timer1Enabled && buzzer.getOutput()->getHalfPeriod() == Waveform::toHalfPeriod(f) && buzzer.getFrequency() == f;
+}
+
+void setUp() {
+   mock::reset();
+   buzzer = Buzzer();
+   buzzer.setup();
+}
+
+void tearDown() {
+}
+
+void test_beep_does_not_block() {
+   uint64_t start = mock::now;
+   buzzer.beep(1000, 5);
+   TEST_ASSERT_EQUAL(start, mock::now);
+
+   buzzer.loop(mock::now);
+   TEST_ASSERT_TRUE(sounds(1000));
+   run(5);
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+   run(10);
+   TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+}
+
+void test_ticking_alternates_on_deadline() {
+   buzzer.startTicking(600);
+   buzzer.loop(mock::now);
+
+   uint32_t tickA = 0;
+   uint32_t tickB = 0;
+   uint16_t last = 0;
+   for ( uint32_t i=0; i < 6000; i++ ) {
+      mock::advance(1);
+      buzzer.loop(mock::now);
+      if ( buzzer.getFrequency() != last ) {
+         tickA += (buzzer.getFrequency() == 100);
+         tickB += (buzzer.getFrequency() == 200);
+         last = buzzer.getFrequency();
+      }
+   }
+   TEST_ASSERT_EQUAL(5, tickA);
+   TEST_ASSERT_EQUAL(5, tickB);
+}
+
+void test_cue_plays_over_ticking() {
+   buzzer.startTicking(600);
+   run(595);
+   buzzer.beepCorrectWire();
+   run(10); // The tick at 600 ms is silent under the cue
+   TEST_ASSERT_TRUE(sounds(4000));
+   run(100);
+   TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+   run(100); // Cue ended, the next tick is heard at 1200 ms
+   TEST_ASSERT_EQUAL(805, mock::now);
+   run(400);
+   TEST_ASSERT_TRUE(sounds(200));
+}
+
+void test_alarm_preempts_feedback() {
+   buzzer.startTicking(600);
+   run(601);
+   TEST_ASSERT_TRUE(sounds(100));
+   buzzer.startLose();
+   buzzer.loop(mock::now);
+   TEST_ASSERT_TRUE(sounds(C));
+
+   // A wire beep during the alarm is not heard, the scale continues on its time.
+   buzzer.beepNotCorrectWire();
+   run(10);
+   TEST_ASSERT_TRUE(sounds(D));
+   TEST_ASSERT_EQUAL(SOUND_PRIORITY_ALARM, buzzer.getMixer()->getHighest());
+   TEST_ASSERT_TRUE(buzzer.getMixer()->isPlaying(SOUND_PRIORITY_FEEDBACK, &SOUND_NOT_CORRECT));
+
+   // The ticking is stopped by the alarm.
+   run(2000);
+   TEST_ASSERT_FALSE(buzzer.getMixer()->isPlaying(SOUND_PRIORITY_TICKING));
+   TEST_ASSERT_EQUAL(0, buzzer.getMixer()->getResumes());
+}
+
+void test_feedback_resumes_ticking() {
+   Mixer* mixer = buzzer.getMixer();
+   buzzer.startTicking(600);
+   run(601);
+   TEST_ASSERT_EQUAL(SOUND_PRIORITY_TICKING, mixer->getHighest());
+
+   // The beep pre-empts the tick that is heard, the tick continues silently.
+   buzzer.beep(2000, 20);
+   buzzer.loop(mock::now);
+   TEST_ASSERT_TRUE(sounds(2000));
+   TEST_ASSERT_EQUAL(1, mixer->getPreemptions());
+
+   // A second beep replaces the first one in the same slot.
+   run(2);
+   buzzer.beep(3000, 2);
+   buzzer.loop(mock::now);
+   TEST_ASSERT_TRUE(sounds(3000));
+   TEST_ASSERT_EQUAL(1, mixer->getPreemptions());
+
+   // The beep ended, the tick that was pre-empted is heard again.
+   run(5);
+   TEST_ASSERT_EQUAL(SOUND_PRIORITY_TICKING, mixer->getHighest());
+   TEST_ASSERT_EQUAL(1, mixer->getResumes());
+
+   // Handling a code entry sets the ticking speed again and keeps its phase.
+   buzzer.startTicking(300);
+   run(593);
+   TEST_ASSERT_EQUAL(1201, mock::now);
+   TEST_ASSERT_TRUE(sounds(200));
+   run(300);
+   TEST_ASSERT_TRUE(sounds(100));
+}
+
+void test_lose_repeats_the_scale() {
+   buzzer.startLose();
+   const uint16_t scale[7] = { C, D, E, F, G, A, B };
+   for ( uint8_t repeat=0; repeat < 3; repeat++ ) {
+      for ( uint8_t i=0; i < 7; i++ ) {
+         buzzer.loop(mock::now);
+         TEST_ASSERT_TRUE(sounds(scale[i]));
+         mock::advance(5);
+         buzzer.loop(mock::now);
+         TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+         mock::advance(5);
+      }
+   }
+}
+
+void test_win_music_and_mute() {
+   buzzer.startWin();
+   buzzer.loop(mock::now);
+   TEST_ASSERT_TRUE(sounds(melodyFrequency(NOTE_E, 4)));
+   run(400); // Quarter note on 150 bpm
+   TEST_ASSERT_TRUE(sounds(melodyFrequency(NOTE_B, 3)));
+
+   buzzer.mute();
+   run(1000);
+   TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+   TEST_ASSERT_EQUAL(LOW, mock::pinLevels[D8]);
+}
+
+void test_timer1_waveform() {
+   TEST_ASSERT_EQUAL(2500, Waveform::toHalfPeriod(1000)); // 5 MHz timer1
+   TEST_ASSERT_EQUAL(250, Waveform::toHalfPeriod(40000)); // Limited to 10 kHz
+
+   // The interrupt toggles D8 every half period.
+   buzzer.on(1000);
+   buzzer.loop(mock::now);
+   TEST_ASSERT_TRUE(mock::timer1Enabled);
+   uint32_t edges = buzzer.getOutput()->getEdges();
+   mock::timer1Fire(1);
+   TEST_ASSERT_EQUAL(HIGH, mock::pinLevels[D8]);
+   mock::timer1Fire(1);
+   TEST_ASSERT_EQUAL(LOW, mock::pinLevels[D8]);
+   mock::timer1Fire(99);
+   TEST_ASSERT_EQUAL(HIGH, mock::pinLevels[D8]);
+   TEST_ASSERT_EQUAL(edges + 101, buzzer.getOutput()->getEdges());
+
+   // A note after a silence starts timer1 with one write and the global PWM is not touched.
+   buzzer.off();
+   buzzer.startWin();
+   uint32_t writes = mock::timer1Writes;
+   uint32_t notes = 0;
+   uint16_t last = buzzer.getFrequency();
+   for ( uint32_t i=0; i < 5000; i++ ) {
+      mock::advance(1);
+      buzzer.loop(mock::now);
+      if ( buzzer.getFrequency() != last && buzzer.getFrequency() != 0 ) {
+         notes++;
+      }
+      last = buzzer.getFrequency();
+   }
+   TEST_ASSERT_GREATER_THAN(10, notes);
+   TEST_ASSERT_EQUAL(notes, mock::timer1Writes - writes);
+   TEST_ASSERT_EQUAL(1000, mock::pwmFrequency);
+   TEST_ASSERT_EQUAL(0, mock::pwmValue[D8]);
+}
+
+// A tone that is played with the envelope and a release after the tone.
+const Envelope ENVELOPE_TEST = { 8, 8, 128, 8, 200 };
+const Tone TEST_TONES[] PROGMEM = { TONE(1000, 20), TONE(0, 20) };
+const Sound SOUND_TEST = { TEST_TONES, 2, 1, &ENVELOPE_TEST };
+
+void test_envelope_volume() {
+   // The alarm is loud, a duty of 50%.
+   buzzer.startLose();
+   buzzer.loop(mock::now);
+   TEST_ASSERT_EQUAL(WAVEFORM_DUTY, buzzer.getOutput()->getDuty());
+   TEST_ASSERT_EQUAL(Waveform::toHalfPeriod(C), buzzer.getOutput()->getHighTicks());
+   buzzer.mute();
+
+   // A menu beep is quiet.
+   buzzer.beep();
+   buzzer.loop(mock::now);
+   run(1);
+   TEST_ASSERT_EQUAL((ENVELOPE_BEEP.volume + 1) / 2, buzzer.getOutput()->getDuty());
+   TEST_ASSERT_EQUAL(2 * 2500 * 24 / 256, buzzer.getOutput()->getHighTicks());
+   buzzer.mute();
+
+   // Attack, decay to the sustain level and the release in the silence after the tone.
+   buzzer.getMixer()->play(SOUND_PRIORITY_FEEDBACK, &SOUND_TEST, mock::now);
+   buzzer.loop(mock::now);
+   uint8_t duties[40];
+   for ( uint8_t i=0; i < 40; i++ ) {
+      run(1);
+      duties[i] = buzzer.getOutput()->getHalfPeriod() > 0 ? buzzer.getOutput()->getDuty() : 0;
+   }
+   TEST_ASSERT_LESS_THAN(duties[7], duties[1]); // Attack in 8 ms
+   TEST_ASSERT_EQUAL(100, duties[7]); // Volume 200
+   TEST_ASSERT_EQUAL(50, duties[15]); // Sustain of half the volume after the decay
+   TEST_ASSERT_EQUAL(50, duties[18]);
+   TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+   TEST_ASSERT_LESS_THAN(50, duties[22]); // The release sounds after the tone of 20 ms
+   TEST_ASSERT_GREATER_THAN(0, duties[22]);
+   TEST_ASSERT_EQUAL(0, duties[30]);
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+}
+
+// The tone of on is played by the mixer, so the loop keeps it until off.
+void test_on_keeps_sounding_until_off() {
+   buzzer.on(2000);
+   run(5000);
+   TEST_ASSERT_TRUE(sounds(2000));
+   TEST_ASSERT_EQUAL(WAVEFORM_DUTY, buzzer.getOutput()->getDuty());
+
+   buzzer.off();
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+   run(10);
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+   TEST_ASSERT_FALSE(buzzer.getMixer()->isPlaying(SOUND_PRIORITY_FEEDBACK));
+}
+
+// The feedback and the ticking fade out in the silence after their tone.
+void test_shipped_envelopes_release() {
+   buzzer.beepCorrectWire();
+   buzzer.loop(mock::now);
+   run(110);
+   TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+   TEST_ASSERT_TRUE(mock::timer1Enabled);
+   TEST_ASSERT_GREATER_THAN(0, buzzer.getOutput()->getDuty());
+   run(40);
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+   buzzer.mute();
+
+   buzzer.getMixer()->play(SOUND_PRIORITY_TICKING, &SOUND_TICK_A, mock::now);
+   buzzer.loop(mock::now);
+   run(6);
+   TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+   TEST_ASSERT_TRUE(mock::timer1Enabled);
+   run(4);
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+}
+
+// A stage of one update from silence to the full level and back does not overflow the step.
+void test_envelope_full_scale_step() {
+   const Envelope full = { ENVELOPE_RATE, ENVELOPE_RATE, 0, 0, 255 };
+   EnvelopeGenerator envelope;
+   envelope.noteOn(&full, mock::now);
+   TEST_ASSERT_EQUAL(ENVELOPE_ATTACK, envelope.getStage());
+   TEST_ASSERT_TRUE(envelope.loop(mock::now + ENVELOPE_RATE));
+   TEST_ASSERT_EQUAL(255, envelope.getLevel());
+   TEST_ASSERT_EQUAL(ENVELOPE_DECAY, envelope.getStage());
+   TEST_ASSERT_TRUE(envelope.loop(mock::now + 2 * ENVELOPE_RATE));
+   TEST_ASSERT_EQUAL(0, envelope.getLevel());
+   TEST_ASSERT_EQUAL(ENVELOPE_SUSTAIN, envelope.getStage());
+}
+
+// Benchmark the loop while the effect is playing. The blocking driver took 200 ms for a wire beep and
+// 70 ms every loop pass for the lose sound, now no loop pass may block.
+void benchEffect(const char* name) {
+   BenchResult r = bench(name, 200000, 1, [](uint32_t) {
+      buzzer.loop(mock::now);
+   });
+   TEST_ASSERT_EQUAL(0, r.maxBlockedMs);
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+void test_bench_loop_per_effect() {
+   buzzer.startTicking(300);
+   benchEffect("Buzzer::loop ticking");
+
+   buzzer.beepCorrectWire();
+   benchEffect("Buzzer::loop correct wire");
+
+   buzzer.beepNotCorrectWire();
+   benchEffect("Buzzer::loop not correct wire");
+
+   buzzer.startLose();
+   benchEffect("Buzzer::loop lose");
+
+   buzzer.startWin();
+   benchEffect("Buzzer::loop win");
+
+   // All three slots play, the loop does the same work.
+   buzzer.startTicking(300);
+   buzzer.getMixer()->play(SOUND_PRIORITY_ALARM, &SOUND_LOSE, mock::now);
+   buzzer.beepCorrectWire();
+   benchEffect("Buzzer::loop alarm over feedback over ticking");
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_beep_does_not_block);
+   RUN_TEST(test_ticking_alternates_on_deadline);
+   RUN_TEST(test_cue_plays_over_ticking);
+   RUN_TEST(test_alarm_preempts_feedback);
+   RUN_TEST(test_feedback_resumes_ticking);
+   RUN_TEST(test_lose_repeats_the_scale);
+   RUN_TEST(test_win_music_and_mute);
+   RUN_TEST(test_timer1_waveform);
+   RUN_TEST(test_envelope_volume);
+   RUN_TEST(test_on_keeps_sounding_until_off);
+   RUN_TEST(test_shipped_envelopes_release);
+   RUN_TEST(test_envelope_full_scale_step);
+   RUN_TEST(test_bench_loop_per_effect);
+   return UNITY_END();
+}
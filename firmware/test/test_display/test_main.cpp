@@ -0,0 +1,139 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_display/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the Display framebuffer.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <timer.hpp>
+
+I2CQueue i2c;
+Display display(&i2c);
+
+// Enqueue the changes of the frame and send them.
+void flush() {
+   display.loop(mock::now);
+   while ( !i2c.isEmpty() ) {
+      i2c.loop(mock::now);
+   }
+}
+
+void setUp() {
+   mock::reset();
+   Wire.reset();
+   i2c.setup();
+   display = Display(&i2c);
+   display.setup();
+   flush();
+}
+
+void tearDown() {
+}
+
+void test_same_frame_is_not_written() {
+   display.setTime(12, 34, true);
+   flush();
+   uint32_t transactions = Wire.transactions;
+
+   display.setTime(12, 34, true);
+   flush();
+   TEST_ASSERT_EQUAL(transactions, Wire.transactions);
+}
+
+void test_only_changed_digit_is_written() {
+   display.setTime(12, 34, true);
+   flush();
+   uint32_t transactions = Wire.transactions;
+
+   display.setTime(12, 33, true);
+   flush();
+   TEST_ASSERT_EQUAL(transactions + 1, Wire.transactions);
+   TEST_ASSERT_EQUAL_HEX8(0x4F, Wire.ram[0][8]);
+}
+
+void test_change_and_back_is_not_written() {
+   display.setTime(12, 34, true);
+   flush();
+   uint32_t transactions = Wire.transactions;
+
+   display.setTime(12, 35, true);
+   display.setTime(12, 34, true);
+   flush();
+   TEST_ASSERT_EQUAL(transactions, Wire.transactions);
+}
+
+void test_blink_is_kept_when_the_queue_is_full() {
+   uint8_t cmd = 0xE4;
+   while ( i2c.available(1) ) {
+      i2c.enqueue(0x70, &cmd, 1);
+   }
+   display.setBlink(2);
+   TEST_ASSERT_EQUAL(0, i2c.getDropped());
+   while ( !i2c.isEmpty() ) {
+      i2c.loop(mock::now);
+   }
+   TEST_ASSERT_EQUAL_HEX8(0xE4, Wire.lastCommand[0]); // The blink is not sent yet
+
+   flush(); // The next loop enqueues it
+   TEST_ASSERT_EQUAL_HEX8(0x85, Wire.lastCommand[0]);
+}
+
+void test_bytes_per_minute_countdown() {
+   Timer timer(&display);
+   Wire.reset();
+   timer.setup();
+   timer.enterCountdown(50);
+   for ( uint32_t i=0; i < 3 * 60 * 1000; i++ ) {
+      mock::advance(1);
+      timer.loop(mock::now);
+      display.loop(mock::now);
+      i2c.loop(mock::now);
+   }
+
+   // Writing all positions every second costs 5 transactions of 3 bytes.
+   uint32_t full = 60 * 5 * 3;
+   uint32_t measured = timer.getDisplay()->getBytesPerMinute();
+   char message[96];
+   snprintf(message, sizeof(message), "Display I2C bytes per minute: %u (full refresh %u)", measured, full);
+   TEST_MESSAGE(message);
+
+   TEST_ASSERT_GREATER_THAN(0, measured);
+   TEST_ASSERT_LESS_THAN(full / 2, measured);
+}
+
+void test_bench_loop() {
+   BenchResult r = bench("Display::loop", 1000000, 1, [](uint32_t i) {
+      display.setTime(i / 60000, (i / 1000) % 60, (i / 1000) % 2);
+      display.loop(mock::now);
+      i2c.reset(); // Only the framebuffer is measured
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_same_frame_is_not_written);
+   RUN_TEST(test_only_changed_digit_is_written);
+   RUN_TEST(test_change_and_back_is_not_written);
+   RUN_TEST(test_blink_is_kept_when_the_queue_is_full);
+   RUN_TEST(test_bytes_per_minute_countdown);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
@@ -0,0 +1,170 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_displaymanager/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the display manager with several displays.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <displaymanager.hpp>
+
+I2CQueue i2c;
+DisplayManager displays(&i2c, DISPLAY_MANAGER_MAX);
+
+// Enqueue the changes of all displays and send them.
+void flush() {
+   displays.loop(mock::now);
+   while ( !i2c.isEmpty() ) {
+      i2c.loop(mock::now);
+   }
+}
+
+void setUp() {
+   mock::reset();
+   Wire.reset();
+   i2c.reset();
+   displays = DisplayManager(&i2c, DISPLAY_MANAGER_MAX);
+   displays.setup();
+   flush();
+}
+
+void tearDown() {
+}
+
+void test_every_display_has_its_own_address() {
+   TEST_ASSERT_EQUAL(DISPLAY_MANAGER_MAX, displays.getTotal());
+   TEST_ASSERT_NULL(displays.get(DISPLAY_MANAGER_MAX));
+
+   for ( uint8_t i=0; i < DISPLAY_MANAGER_MAX; i++ ) {
+      displays.get(i)->setTime(i, i, false);
+   }
+   flush();
+
+   for ( uint8_t i=0; i < DISPLAY_MANAGER_MAX; i++ ) {
+      TEST_ASSERT_EQUAL_HEX8(0xE4, Wire.lastCommand[i]); // Initialized with brightness 4
+      TEST_ASSERT_EQUAL_HEX8(fontGlyph('0' + i), Wire.ram[i][2]);
+      TEST_ASSERT_EQUAL_HEX8(fontGlyph('0' + i), Wire.ram[i][8]);
+   }
+}
+
+void test_total_is_clamped() {
+   DisplayManager none(&i2c, 0);
+   TEST_ASSERT_EQUAL(1, none.getTotal());
+   none.loop(mock::now); // No division by zero
+   DisplayManager many(&i2c, 20);
+   TEST_ASSERT_EQUAL(DISPLAY_MANAGER_MAX, many.getTotal());
+}
+
+void test_dirty_frames_in_one_bus_pass() {
+   uint8_t text[4] = { 0x76, 0x77, 0x38, 0x38 };
+   for ( uint8_t i=0; i < DISPLAY_MANAGER_MAX; i++ ) {
+      displays.get(i)->setRaw(text, true);
+   }
+
+   // Every changed frame is one transaction of the address, RAM pointer and 9 bytes.
+   uint32_t transactions = Wire.transactions;
+   uint32_t bytes = Wire.bytes;
+   displays.loop(mock::now);
+   TEST_ASSERT_EQUAL(DISPLAY_MANAGER_MAX, i2c.getCount());
+   flush();
+   TEST_ASSERT_EQUAL(DISPLAY_MANAGER_MAX, Wire.transactions - transactions);
+   TEST_ASSERT_EQUAL(DISPLAY_MANAGER_MAX * 11, Wire.bytes - bytes);
+   TEST_ASSERT_EQUAL_HEX8(0x38, Wire.ram[7][8]);
+}
+
+void test_full_queue_keeps_displays_dirty() {
+   uint8_t cmd = 0x81;
+   for ( uint8_t i=0; i < I2C_QUEUE_SIZE - 3; i++ ) {
+      i2c.enqueue(0x70, &cmd, 1);
+   }
+   for ( uint8_t i=0; i < DISPLAY_MANAGER_MAX; i++ ) {
+      displays.get(i)->setTime(12, 34, true);
+   }
+   displays.loop(mock::now); // Only three displays fit, the others wait without dropping
+   TEST_ASSERT_EQUAL(0, i2c.getDropped());
+
+   uint8_t dirty = 0;
+   for ( uint8_t i=0; i < DISPLAY_MANAGER_MAX; i++ ) {
+      dirty += displays.get(i)->isDirty();
+   }
+   TEST_ASSERT_EQUAL(DISPLAY_MANAGER_MAX - 3, dirty);
+
+   while ( !i2c.isEmpty() ) {
+      i2c.loop(mock::now);
+   }
+   flush();
+   for ( uint8_t i=0; i < DISPLAY_MANAGER_MAX; i++ ) {
+      TEST_ASSERT_FALSE(displays.get(i)->isDirty());
+      TEST_ASSERT_EQUAL_HEX8(fontGlyph('4'), Wire.ram[i][8]);
+   }
+}
+
+void test_bus_utilization_per_display_count() {
+   // Every display counts down in tenths of seconds, the worst case of the countdown.
+   for ( uint8_t n=1; n <= DISPLAY_MANAGER_MAX; n *= 2 ) {
+      mock::reset();
+      Wire.reset();
+      i2c.reset();
+      displays = DisplayManager(&i2c, n);
+      displays.setup();
+      flush();
+      i2c.reset();
+
+      uint64_t start = mock::now;
+      while ( mock::now - start < 10000 ) {
+         mock::advance(1);
+         uint16_t tenths = 600 - (mock::now - start) / 100;
+         for ( uint8_t i=0; i < n; i++ ) {
+            displays.get(i)->setTenths(tenths);
+         }
+         displays.loop(mock::now);
+         i2c.loop(mock::now);
+      }
+
+      uint64_t busy = i2c.getBusy();
+      uint64_t elapsed = (mock::now - start) * 1000;
+      char message[128];
+      snprintf(message, sizeof(message), "%d displays: %u bytes/s, bus busy %.2f%% (%u us per transaction max)",
+               n, (unsigned) (displays.getBytes() / 10), 100.0 * busy / elapsed, (unsigned) i2c.getDurationMax());
+      TEST_MESSAGE(message);
+
+      TEST_ASSERT_EQUAL(0, i2c.getDropped());
+      TEST_ASSERT_LESS_THAN(elapsed / 20, busy); // Less than 5% of the bus
+   }
+}
+
+void test_bench_loop() {
+   BenchResult r = bench("DisplayManager::loop 8 displays", 1000000, 1, [](uint32_t i) {
+      displays.get(i % DISPLAY_MANAGER_MAX)->setTime(i / 60000, (i / 1000) % 60, (i / 1000) % 2);
+      displays.loop(mock::now);
+      i2c.reset(); // Only the framebuffers are measured
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_every_display_has_its_own_address);
+   RUN_TEST(test_total_is_clamped);
+   RUN_TEST(test_dirty_frames_in_one_bus_pass);
+   RUN_TEST(test_full_queue_keeps_displays_dirty);
+   RUN_TEST(test_bus_utilization_per_display_count);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
@@ -0,0 +1,127 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_font/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the 7-segments font and text rendering.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <timer.hpp>
+
+// Fixed texts are rendered by the compiler.
+constexpr FontText LOSE = fontText("LOSE");
+static_assert(LOSE.digits[0] == (SEG_D | SEG_E | SEG_F), "L");
+static_assert(LOSE.digits[1] == (SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F), "O");
+static_assert(LOSE.digits[2] == (SEG_A | SEG_C | SEG_D | SEG_F | SEG_G), "S");
+static_assert(LOSE.digits[3] == (SEG_A | SEG_D | SEG_E | SEG_F | SEG_G), "E");
+static_assert(fontText("12.5").digits[1] == (0x5B | FONT_DP), "Dot on the digit before");
+static_assert(fontText("12.5").digits[3] == 0x00, "Short text is filled with blanks");
+
+I2CQueue i2c;
+DisplayManager displays(&i2c);
+Timer timer(displays.get(0));
+
+// Run the timer for the given simulated time, 1 ms per pass.
+void run(uint32_t ms) {
+   for ( uint32_t i=0; i < ms; i++ ) {
+      mock::advance(1);
+      timer.loop(mock::now);
+      displays.loop(mock::now);
+      i2c.loop(mock::now);
+   }
+}
+
+void setUp() {
+   mock::reset();
+   Wire.reset();
+   i2c.reset();
+   displays = DisplayManager(&i2c);
+   displays.setup();
+   timer = Timer(displays.get(0));
+   timer.setup();
+}
+
+void tearDown() {
+}
+
+void test_table_matches_font() {
+   for ( char c=FONT_FIRST; c < FONT_LAST; c++ ) {
+      TEST_ASSERT_EQUAL_HEX8(fontGlyph(c), fontRead(c));
+   }
+   TEST_ASSERT_EQUAL_HEX8(0x00, fontRead('\n'));
+}
+
+void test_runtime_render_matches_compile_time() {
+   FontText t = fontRender("LOSE");
+   TEST_ASSERT_EQUAL_HEX8_ARRAY(LOSE.digits, t.digits, 4);
+}
+
+void test_dots() {
+   TEST_ASSERT_EQUAL(3, fontLength("12.5"));
+   TEST_ASSERT_EQUAL(2, fontLength(".."));
+   TEST_ASSERT_EQUAL_STRING("5", fontSkip("12.5", 2));
+
+   FontText t = fontRender("1.2.3.4.");
+   for ( uint8_t i=0; i < 4; i++ ) {
+      TEST_ASSERT_TRUE(t.digits[i] & FONT_DP);
+   }
+}
+
+void test_show_text_scrolls() {
+   timer.showText("HELLO");
+   run(10);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('H'), Wire.ram[0][0]);
+
+   run(300);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('E'), Wire.ram[0][0]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('O'), Wire.ram[0][8]);
+
+   timer.showYeah(); // Stops scrolling
+   run(1000);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('Y'), Wire.ram[0][0]);
+}
+
+void test_bench_render() {
+   BenchResult r = bench("fontRender", 1000000, 0, [](uint32_t) {
+      volatile FontText t = fontRender("gA 1");
+      (void) t;
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+void test_bench_loop_scrolling() {
+   timer.showText("HACK THE BOM");
+   BenchResult r = bench("Timer::loop scrolling", 1000000, 1, [](uint32_t) {
+      timer.loop(mock::now);
+      displays.loop(mock::now);
+      i2c.reset();
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_table_matches_font);
+   RUN_TEST(test_runtime_render_matches_compile_time);
+   RUN_TEST(test_dots);
+   RUN_TEST(test_show_text_scrolls);
+   RUN_TEST(test_bench_render);
+   RUN_TEST(test_bench_loop_scrolling);
+   return UNITY_END();
+}
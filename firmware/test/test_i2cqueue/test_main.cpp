@@ -0,0 +1,224 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_i2cqueue/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the I2C transaction queue.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Added the tests of the retries and the bus recovery.
+ *               19-10-2026 (MS): A missing device drops only its transaction, setup keeps the queue.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <i2cqueue.hpp>
+
+I2CQueue i2c;
+
+void setUp() {
+   mock::reset();
+   Wire.reset();
+   Wire.setClock(400000);
+   i2c.reset();
+}
+
+void tearDown() {
+}
+
+void test_transactions_are_sent_in_order() {
+   uint8_t a[2] = { 0x00, 0x3F };
+   uint8_t b[2] = { 0x00, 0x06 };
+   i2c.enqueue(0x70, a, 2);
+   i2c.enqueue(0x70, b, 2);
+   i2c.loop(mock::now);
+
+   TEST_ASSERT_TRUE(i2c.isEmpty());
+   TEST_ASSERT_EQUAL(2, Wire.transactions);
+   TEST_ASSERT_EQUAL_HEX8(0x06, Wire.ram[0][0]);
+}
+
+void test_budget_bounds_one_loop_pass() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   for ( uint8_t i=0; i < I2C_QUEUE_SIZE; i++ ) {
+      TEST_ASSERT_TRUE(i2c.enqueue(0x70, data, 2));
+   }
+   TEST_ASSERT_FALSE(i2c.enqueue(0x70, data, 2));
+   TEST_ASSERT_EQUAL(1, i2c.getDropped());
+
+   uint32_t passes = 0;
+   while ( !i2c.isEmpty() ) {
+      uint32_t start = micros();
+      uint32_t sent = Wire.transactions;
+      i2c.loop(mock::now);
+      passes++;
+
+      // The budget is checked after every transaction, so one transaction may pass it.
+      TEST_ASSERT_LESS_THAN(I2C_QUEUE_BUDGET + 100, micros() - start);
+      TEST_ASSERT_GREATER_THAN(sent, Wire.transactions);
+   }
+
+   char message[96];
+   snprintf(message, sizeof(message), "16 transactions in %u loop passes", passes);
+   TEST_MESSAGE(message);
+   TEST_ASSERT_GREATER_THAN(1, passes);
+   TEST_ASSERT_EQUAL(I2C_QUEUE_SIZE, i2c.getCompleted());
+}
+
+void test_latency_statistics() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   for ( uint8_t i=0; i < 8; i++ ) {
+      i2c.enqueue(0x70, data, 2);
+   }
+   while ( !i2c.isEmpty() ) {
+      i2c.loop(mock::now);
+   }
+
+   // A transaction of 3 bytes takes 67 us on 400kHz, the last one waits for the seven before it.
+   char message[128];
+   snprintf(message, sizeof(message), "I2C latency average %u us, max %u us, transaction max %u us",
+            i2c.getLatencyAverage(), i2c.getLatencyMax(), i2c.getDurationMax());
+   TEST_MESSAGE(message);
+   TEST_ASSERT_UINT32_WITHIN(2, 67, i2c.getDurationMax());
+   TEST_ASSERT_UINT32_WITHIN(10, 8 * 67, i2c.getLatencyMax());
+   TEST_ASSERT_LESS_THAN(i2c.getLatencyMax(), i2c.getLatencyAverage());
+}
+
+void test_nack_is_retried() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   i2c.enqueue(0x70, data, 2);
+   Wire.failResult = I2C_NACK_DATA;
+   Wire.failCount = 1;
+
+   i2c.loop(mock::now); // Not acknowledged, stays in the queue
+   TEST_ASSERT_FALSE(i2c.isEmpty());
+   i2c.loop(mock::now);
+   TEST_ASSERT_TRUE(i2c.isEmpty());
+
+   TEST_ASSERT_EQUAL(1, i2c.getNacks());
+   TEST_ASSERT_EQUAL(1, i2c.getRetries());
+   TEST_ASSERT_EQUAL(0, i2c.getErrors());
+   TEST_ASSERT_EQUAL(0, i2c.getRecoveries());
+   TEST_ASSERT_EQUAL_HEX8(0x3F, Wire.ram[0][0]);
+}
+
+void test_missing_device_drops_only_its_transaction() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   uint8_t other[2] = { 0x00, 0x06 };
+   i2c.enqueue(0x71, data, 2);
+   i2c.enqueue(0x70, other, 2);
+   Wire.failResult = I2C_NACK_ADDRESS;
+   Wire.failCount = I2C_QUEUE_RETRIES + 1; // Every try of the first transaction
+
+   for ( uint8_t i=0; i <= I2C_QUEUE_RETRIES; i++ ) {
+      i2c.loop(mock::now);
+   }
+   TEST_ASSERT_EQUAL(I2C_QUEUE_RETRIES + 1, i2c.getNacks());
+   TEST_ASSERT_EQUAL(I2C_QUEUE_RETRIES, i2c.getRetries());
+   TEST_ASSERT_EQUAL(1, i2c.getErrors());
+
+   // The bus is fine, so it is not recovered and the other transaction is still sent without waiting.
+   TEST_ASSERT_EQUAL(0, i2c.getRecoveries());
+   TEST_ASSERT_EQUAL(0, Wire.begins);
+   TEST_ASSERT_EQUAL(0, i2c.getDropped());
+   TEST_ASSERT_TRUE(i2c.isEmpty());
+   TEST_ASSERT_EQUAL(1, i2c.getCompleted());
+   TEST_ASSERT_EQUAL_HEX8(0x06, Wire.ram[0][0]);
+}
+
+void test_hung_bus_recovers_after_a_holdoff() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   i2c.enqueue(0x70, data, 2);
+   i2c.enqueue(0x70, data, 2);
+   Wire.failResult = 4; // Bus busy, SDA or SCL held low
+   Wire.failCount = 0xFFFFFFFF;
+
+   i2c.loop(mock::now);
+   TEST_ASSERT_EQUAL(1, i2c.getErrors());
+   TEST_ASSERT_EQUAL(1, i2c.getRecoveries());
+   TEST_ASSERT_EQUAL(1, Wire.begins);
+   TEST_ASSERT_EQUAL(I2C_QUEUE_TIMEOUT, Wire.stretchLimit);
+   TEST_ASSERT_TRUE(i2c.isEmpty()); // The waiting transaction is discarded
+   TEST_ASSERT_EQUAL(1, i2c.getDropped());
+
+   // The queue waits after a recovery, so a broken cable does not cost every loop pass.
+   i2c.enqueue(0x70, data, 2);
+   uint32_t transactions = Wire.transactions;
+   mock::advance(I2C_QUEUE_HOLDOFF - 1);
+   i2c.loop(mock::now);
+   TEST_ASSERT_EQUAL(transactions, Wire.transactions);
+
+   Wire.failCount = 0;
+   mock::advance(1);
+   i2c.loop(mock::now);
+   TEST_ASSERT_TRUE(i2c.isEmpty());
+   TEST_ASSERT_EQUAL(1, i2c.getRecoveries());
+}
+
+void test_setup_keeps_the_waiting_transactions() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   i2c.enqueue(0x70, data, 2); // The display driver is set up before the queue
+
+   i2c.setup();
+   TEST_ASSERT_EQUAL(1, i2c.getCount());
+   i2c.loop(mock::now);
+   TEST_ASSERT_EQUAL_HEX8(0x3F, Wire.ram[0][0]);
+}
+
+void test_hung_bus_times_out() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   i2c.enqueue(0x70, data, 2);
+   Wire.failResult = 4; // Bus busy, SDA or SCL held low
+   Wire.failCount = 1;
+   Wire.failUs = I2C_QUEUE_TIMEOUT;
+   mock::pinLevels[I2C_QUEUE_SDA] = LOW; // The slave does not release SDA, all 9 clocks are given
+
+   uint32_t start = micros();
+   i2c.loop(mock::now);
+   uint32_t duration = micros() - start;
+
+   char message[96];
+   snprintf(message, sizeof(message), "Hung bus loop pass with recovery: %u us", duration);
+   TEST_MESSAGE(message);
+   TEST_ASSERT_EQUAL(1, i2c.getTimeouts());
+   TEST_ASSERT_EQUAL(1, i2c.getRecoveries());
+   TEST_ASSERT_LESS_THAN(I2C_QUEUE_TIMEOUT + 200, duration);
+   TEST_ASSERT_EQUAL(OUTPUT_OPEN_DRAIN, mock::pinModes[I2C_QUEUE_SCL]);
+}
+
+void test_bench_loop() {
+   uint8_t data[2] = { 0x00, 0x3F };
+   BenchResult r = bench("I2CQueue::loop", 1000000, 1, [&data](uint32_t i) {
+      if ( i % 100 == 0 ) {
+         i2c.enqueue(0x70, data, 2);
+      }
+      i2c.loop(mock::now);
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_transactions_are_sent_in_order);
+   RUN_TEST(test_budget_bounds_one_loop_pass);
+   RUN_TEST(test_latency_statistics);
+   RUN_TEST(test_nack_is_retried);
+   RUN_TEST(test_missing_device_drops_only_its_transaction);
+   RUN_TEST(test_hung_bus_recovers_after_a_holdoff);
+   RUN_TEST(test_setup_keeps_the_waiting_transactions);
+   RUN_TEST(test_hung_bus_times_out);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
@@ -0,0 +1,157 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_melody/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the packed melodies and the sequencer.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Tones of 0 ms in a sound that repeats forever.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <sound.hpp>
+#include <melodies.hpp>
+
+static_assert(MELODY_NOTE(E, 4) == 0x25, "Quarter E");
+static_assert(MELODY_DOTTED_NOTE(B, 8) == 0xBC, "Dotted eighth B");
+static_assert(MELODY_REST(2) == 0x10, "Half rest");
+static_assert(MELODY_SET_OCTAVE(3) == 0x3F, "Octave 3");
+
+// Test melody on 120 bpm: a whole note is 2000 ms.
+const uint8_t TEST_NOTES[] PROGMEM = {
+   MELODY_NOTE(A, 4), MELODY_REST(8), MELODY_SET_OCTAVE(5), MELODY_DOTTED_NOTE(A, 4), MELODY_NOTE(C, 16),
+};
+const Melody MELODY_TEST = { TEST_NOTES, sizeof(TEST_NOTES), 120, 2 };
+
+Sequencer sequencer;
+
+void setUp() {
+   mock::reset();
+   sequencer = Sequencer();
+}
+
+void tearDown() {
+}
+
+void test_frequencies() {
+   TEST_ASSERT_EQUAL(440, melodyFrequency(NOTE_A, 4));
+   TEST_ASSERT_EQUAL(220, melodyFrequency(NOTE_A, 3));
+   TEST_ASSERT_EQUAL(261, melodyFrequency(NOTE_C, 4));
+   TEST_ASSERT_EQUAL(7902, melodyFrequency(NOTE_B, 8));
+}
+
+void test_durations() {
+   TEST_ASSERT_EQUAL(500, melodyDuration(MELODY_NOTE(A, 4), 2000));
+   TEST_ASSERT_EQUAL(750, melodyDuration(MELODY_DOTTED_NOTE(A, 4), 2000));
+   TEST_ASSERT_EQUAL(62, melodyDuration(MELODY_NOTE(A, 32), 2000));
+   TEST_ASSERT_EQUAL(2000, melodyDuration(MELODY_NOTE(A, 1), 2000));
+}
+
+// The table of half periods has the same notes as the frequencies.
+void test_half_periods() {
+   for ( uint8_t octave=0; octave < MELODY_OCTAVES; octave++ ) {
+      for ( uint8_t pitch=NOTE_C; pitch <= NOTE_B; pitch++ ) {
+         TEST_ASSERT_EQUAL_UINT32(Waveform::toHalfPeriod(melodyFrequency(pitch, octave)), melodyHalfPeriod(pitch, octave));
+      }
+   }
+   TEST_ASSERT_EQUAL_UINT32(5681, melodyHalfPeriod(NOTE_A, 4)); // 440 Hz on the 5 MHz timer1
+}
+
+void test_sequencer_plays_melody() {
+   // Frequency and start time of every tone, a note is followed by a gap of an eighth of its duration.
+   const uint16_t expected[][2] = { { 440, 0 }, { 0, 438 }, { 0, 500 }, { 880, 750 }, { 0, 1407 },
+                                    { 523, 1500 }, { 0, 1610 }, { 440, 1625 } };
+   sequencer.play(&MELODY_TEST, 0);
+   Tone t;
+   for ( uint8_t i=0; i < 8; i++ ) {
+      mock::now = expected[i][1];
+      TEST_ASSERT_EQUAL(SOUND_TONE, sequencer.loop(mock::now, &t));
+      TEST_ASSERT_EQUAL(expected[i][0], t.frequency);
+      TEST_ASSERT_EQUAL_UINT32(Waveform::toHalfPeriod(expected[i][0]), t.halfPeriod); // From the table
+      if ( i == 0 ) {
+         TEST_ASSERT_EQUAL(SOUND_IDLE, sequencer.loop(mock::now + 1, &t));
+      }
+   }
+}
+
+void test_melody_repeats_and_ends() {
+   sequencer.play(&MELODY_TEST, 0);
+   Tone t;
+   uint32_t tones = 0;
+   SoundStatus status;
+   for ( uint32_t ms=0; ms < 10000; ms++ ) {
+      status = sequencer.loop(ms, &t);
+      if ( status == SOUND_TONE ) {
+         tones++;
+      }
+      if ( status == SOUND_END ) {
+         break;
+      }
+   }
+   TEST_ASSERT_EQUAL(SOUND_END, status);
+   TEST_ASSERT_EQUAL(2 * 7, tones); // Played twice, the octave starts at 4 again
+   TEST_ASSERT_FALSE(sequencer.isPlaying());
+}
+
+// A sound that repeats forever with tones of 0 ms plays them as 1 ms and the loop returns.
+const Tone ZERO_TONES[] PROGMEM = { TONE(1000, 0), TONE(0, 0) };
+const Sound SOUND_ZERO = { ZERO_TONES, 2, 0, NULL };
+
+void test_zero_duration_tones_end_the_loop() {
+   sequencer.play(&SOUND_ZERO, 0);
+   Tone t;
+   TEST_ASSERT_EQUAL(SOUND_TONE, sequencer.loop(0, &t));
+   TEST_ASSERT_EQUAL(1, t.duration);
+   TEST_ASSERT_EQUAL(SOUND_IDLE, sequencer.loop(0, &t));
+   TEST_ASSERT_EQUAL(SOUND_TONE, sequencer.loop(100, &t)); // A late loop skips the missed tones
+   TEST_ASSERT_TRUE(sequencer.isPlaying(&SOUND_ZERO));
+}
+
+void test_win_melody_size() {
+   // The win music was 57 notes of uint32_t in the RAM of every Buzzer.
+   uint16_t notes = 0;
+   for ( uint16_t i=0; i < MELODY_WIN.length; i++ ) {
+      notes += ((WIN_NOTES[i] & 0x0F) != NOTE_OCTAVE);
+   }
+   char message[96];
+   snprintf(message, sizeof(message), "Win melody: %u notes in %u bytes flash (was 228 bytes RAM)", notes, MELODY_WIN.length);
+   TEST_MESSAGE(message);
+   TEST_ASSERT_LESS_OR_EQUAL(2 * notes, MELODY_WIN.length); // One or two bytes per note
+   TEST_ASSERT_LESS_THAN(57 * 4, MELODY_WIN.length);
+}
+
+void test_bench_loop() {
+   sequencer.play(&MELODY_WIN, mock::now);
+   Tone t;
+   BenchResult r = bench("Sequencer::loop win melody", 1000000, 1, [&t](uint32_t) {
+      sequencer.loop(mock::now, &t);
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_frequencies);
+   RUN_TEST(test_half_periods);
+   RUN_TEST(test_durations);
+   RUN_TEST(test_sequencer_plays_melody);
+   RUN_TEST(test_melody_repeats_and_ends);
+   RUN_TEST(test_zero_duration_tones_end_the_loop);
+   RUN_TEST(test_win_melody_size);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_pcm/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the sampled sounds on the sigma-delta modulator.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <buzzer.hpp>
+
+PcmPlayer pcm;
+
+// Play one ms: the interrupt fires 8 times on 8 kHz and the samples are compared with the sample in flash.
+uint32_t played = 0;
+uint32_t wrong = 0;
+void interrupts(const Sample* sample, uint32_t times) {
+   for ( uint32_t i=0; i < times; i++ ) {
+      uint32_t writes = mock::sigmaDeltaWrites;
+      mock::timer1Fire(1);
+      if ( mock::sigmaDeltaWrites != writes ) {
+         wrong += ((GPSD & 0xFF) != sample->data[played++]);
+      }
+   }
+}
+
+void setUp() {
+   mock::reset();
+   pcm = PcmPlayer(D8);
+   played = 0;
+   wrong = 0;
+}
+
+void tearDown() {
+}
+
+void test_explosion_sample() {
+   TEST_ASSERT_EQUAL(4000, SAMPLE_EXPLOSION.length);
+   uint8_t min = 255;
+   uint8_t max = 0;
+   for ( uint16_t i=0; i < SAMPLE_EXPLOSION.length; i++ ) {
+      min = (SAMPLE_EXPLOSION.data[i] < min ? SAMPLE_EXPLOSION.data[i] : min);
+      max = (SAMPLE_EXPLOSION.data[i] > max ? SAMPLE_EXPLOSION.data[i] : max);
+   }
+   TEST_ASSERT_LESS_THAN(PCM_SILENCE - 20, min); // Loud at the start
+   TEST_ASSERT_GREATER_THAN(PCM_SILENCE + 20, max);
+   TEST_ASSERT_UINT32_WITHIN(1, PCM_SILENCE, SAMPLE_EXPLOSION.data[SAMPLE_EXPLOSION.length - 1]); // Silent at the end
+}
+
+// The low pass moves a sample at most 126 from the previous one, a value that wraps around jumps further.
+void test_explosion_does_not_wrap() {
+   for ( uint16_t i=1; i < SAMPLE_EXPLOSION.length; i++ ) {
+      int16_t step = (int16_t) SAMPLE_EXPLOSION.data[i] - SAMPLE_EXPLOSION.data[i - 1];
+      TEST_ASSERT_LESS_OR_EQUAL(126, step < 0 ? -step : step);
+   }
+}
+
+void test_plays_every_sample_in_order() {
+   pcm.play(&SAMPLE_EXPLOSION, mock::now);
+   TEST_ASSERT_EQUAL(D8, mock::sigmaDeltaPin);
+   TEST_ASSERT_TRUE(mock::timer1Enabled);
+   TEST_ASSERT_EQUAL(PCM_TICKS, mock::timer1Ticks);
+
+   while ( pcm.isPlaying() ) {
+      mock::advance(1);
+      interrupts(&SAMPLE_EXPLOSION, 8);
+      pcm.loop();
+   }
+   TEST_ASSERT_EQUAL(4000, played);
+   TEST_ASSERT_EQUAL(0, wrong);
+   TEST_ASSERT_EQUAL(4000, pcm.getSamples());
+   TEST_ASSERT_EQUAL(0, pcm.getUnderruns());
+   TEST_ASSERT_UINT32_WITHIN(2, 500, mock::now); // 0.5 s on 8 kHz
+   TEST_ASSERT_FALSE(mock::timer1Enabled);
+   TEST_ASSERT_EQUAL(-1, mock::sigmaDeltaPin);
+}
+
+void test_underrun_keeps_the_order() {
+   pcm.play(&SAMPLE_EXPLOSION, mock::now);
+
+   // The loop is stalled for 50 ms: both buffers of 8 ms are played and then the interrupt waits.
+   mock::advance(50);
+   interrupts(&SAMPLE_EXPLOSION, 50 * 8);
+   TEST_ASSERT_EQUAL(2 * PCM_BLOCK, played);
+   TEST_ASSERT_EQUAL(50 * 8 - 2 * PCM_BLOCK, pcm.getUnderruns());
+
+   while ( pcm.isPlaying() ) {
+      mock::advance(1);
+      interrupts(&SAMPLE_EXPLOSION, 8);
+      pcm.loop();
+   }
+   TEST_ASSERT_EQUAL(4000, played);
+   TEST_ASSERT_EQUAL(0, wrong);
+}
+
+void test_load_of_the_interrupt() {
+   // Every interrupt takes 100 cycles between the two reads of the cycle counter: 100 * 8000 / 80 MHz = 1%.
+   mock::cyclesPerRead = 100;
+   pcm.play(&SAMPLE_EXPLOSION, mock::now);
+   while ( pcm.isPlaying() ) {
+      mock::advance(1);
+      interrupts(&SAMPLE_EXPLOSION, 8);
+      pcm.loop();
+   }
+   TEST_ASSERT_UINT32_WITHIN(2, 100, pcm.getLoad(mock::now));
+   mock::advance(10000);
+   TEST_ASSERT_UINT32_WITHIN(2, 100, pcm.getLoad(mock::now)); // Only the time that it played
+}
+
+void test_buzzer_tones_after_the_sample() {
+   Buzzer buzzer;
+   buzzer.setup();
+   buzzer.startLose();
+   buzzer.loop(mock::now);
+   TEST_ASSERT_EQUAL(C, buzzer.getFrequency());
+
+   buzzer.playSample(&SAMPLE_EXPLOSION);
+   TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+   while ( buzzer.getPcm()->isPlaying() ) {
+      mock::advance(1);
+      interrupts(&SAMPLE_EXPLOSION, 8);
+      buzzer.loop(mock::now);
+      TEST_ASSERT_EQUAL(0, buzzer.getFrequency());
+   }
+   TEST_ASSERT_EQUAL(0, wrong);
+
+   // The alarm continued silently and the square wave has timer1 again.
+   for ( uint8_t i=0; i < 10 && buzzer.getFrequency() == 0; i++ ) {
+      mock::advance(1);
+      buzzer.loop(mock::now);
+   }
+   TEST_ASSERT_GREATER_THAN(0, buzzer.getFrequency());
+   uint32_t edges = buzzer.getOutput()->getEdges();
+   mock::timer1Fire(4);
+   TEST_ASSERT_EQUAL(edges + 4, buzzer.getOutput()->getEdges());
+}
+
+void test_bench_interrupt_and_loop() {
+   // The interrupt cost on the host, as part of the 125 us between two samples.
+   pcm.play(&SAMPLE_EXPLOSION, mock::now);
+   BenchResult r = bench("PcmPlayer interrupt", 1000000, 0, [](uint32_t i) {
+      mock::timer1Fire(1);
+      if ( (i & 31) == 0 ) {
+         pcm.loop();
+         if ( !pcm.isPlaying() ) {
+            pcm.play(&SAMPLE_EXPLOSION, mock::now);
+         }
+      }
+   });
+   char message[96];
+   snprintf(message, sizeof(message), "ISR load on the host at 8 kHz: %.3f%% CPU", r.nsPerCall * PCM_RATE / 1e7);
+   TEST_MESSAGE(message);
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_explosion_sample);
+   RUN_TEST(test_explosion_does_not_wrap);
+   RUN_TEST(test_plays_every_sample_in_order);
+   RUN_TEST(test_underrun_keeps_the_order);
+   RUN_TEST(test_load_of_the_interrupt);
+   RUN_TEST(test_buzzer_tones_after_the_sample);
+   RUN_TEST(test_bench_interrupt_and_loop);
+   return UNITY_END();
+}
@@ -0,0 +1,154 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_puzzle/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the seeded puzzle generator and the replay of a game.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <wires.hpp>
+
+Buzzer buzzer;
+Wires<> wires(&buzzer);
+Wires<64, WireShiftRegister<64>> wires64(&buzzer);
+
+uint8_t values[64];
+
+void setUp() {
+   mock::reset();
+   buzzer.setup();
+}
+
+void tearDown() {
+}
+
+// Fill the values with 1-total and shuffle them with the seed.
+void shuffle(uint32_t seed, uint8_t total) {
+   for ( uint8_t i=0; i < total; i++ ) {
+      values[i] = i + 1;
+   }
+   Puzzle puzzle(seed);
+   puzzle.shuffle(values, total);
+}
+
+void test_shuffle_is_permutation() {
+   for ( uint32_t seed=1; seed < 200; seed++ ) {
+      shuffle(seed * 2654435761UL, 64);
+      uint64_t seen = 0;
+      for ( uint8_t i=0; i < 64; i++ ) {
+         TEST_ASSERT_TRUE(values[i] >= 1 && values[i] <= 64);
+         seen |= 1ULL << (values[i] - 1);
+      }
+      TEST_ASSERT_TRUE(seen == ~0ULL);
+   }
+}
+
+void test_same_seed_same_order() {
+   uint8_t first[64];
+   shuffle(0xC0FFEE, 64);
+   memcpy(first, values, sizeof(first));
+   shuffle(0xC0FFEE, 64);
+   TEST_ASSERT_EQUAL(0, memcmp(first, values, sizeof(first)));
+   shuffle(0xC0FFEF, 64);
+   TEST_ASSERT_TRUE(memcmp(first, values, sizeof(first)) != 0);
+
+   Puzzle zero(0); // A seed of 0 would stop the generator
+   TEST_ASSERT_TRUE(zero.next() != 0);
+}
+
+// Every order of three wires has the same chance.
+void test_shuffle_uniform() {
+   uint32_t counts[6] = { 0 };
+   for ( uint32_t seed=1; seed <= 60000; seed++ ) {
+      shuffle(seed * 2654435761UL, 3);
+      counts[(values[0] - 1) * 2 + (values[1] > values[2] ? 1 : 0)]++;
+   }
+   for ( uint8_t i=0; i < 6; i++ ) {
+      TEST_ASSERT_UINT32_WITHIN(500, 10000, counts[i]);
+   }
+}
+
+void test_new_game_new_seed() {
+   wires.setup();
+   uint32_t seed = wires.getSeed();
+   wires.setup();
+   TEST_ASSERT_TRUE(seed != wires.getSeed());
+   TEST_ASSERT_TRUE(wires.getSeed() != 0);
+}
+
+void test_replay_seed() {
+   wires.setup();
+   uint32_t seed = wires.getSeed();
+   char code[8];
+   strcpy(code, wires.getCode());
+
+   wires.setup(); // Another game
+   wires.setSeed(seed);
+   wires.setup(); // The replay
+   TEST_ASSERT_EQUAL_UINT32(seed, wires.getSeed());
+   TEST_ASSERT_EQUAL_STRING(code, wires.getCode());
+
+   wires.setup(); // The replay is only once
+   TEST_ASSERT_TRUE(seed != wires.getSeed());
+}
+
+// The generation takes one random number per wire but the first, for any seed and any number of wires.
+void test_draws_per_wire() {
+   for ( uint8_t total=1; total <= 64; total++ ) {
+      for ( uint32_t seed=1; seed < 20; seed++ ) {
+         for ( uint8_t i=0; i < total; i++ ) {
+            values[i] = i + 1;
+         }
+         Puzzle puzzle(seed * 2654435761UL);
+         puzzle.shuffle(values, total);
+         TEST_ASSERT_EQUAL_UINT32(total - 1, puzzle.getDraws());
+      }
+   }
+}
+
+void test_bench_generation() {
+   BenchResult r = bench("Puzzle::shuffle 64", 200000, 0, [](uint32_t i) {
+      shuffle(i + 1, 64);
+   });
+   TEST_ASSERT_EQUAL(0, r.maxBlockedMs);
+}
+
+void test_replay_sixty_four_wires() {
+   wires64.setSeed(0x1234ABCD);
+   wires64.setup();
+   char code[120];
+   strcpy(code, wires64.getCode());
+   wires64.setup();
+   wires64.setSeed(0x1234ABCD);
+   wires64.setup();
+   TEST_ASSERT_EQUAL_STRING(code, wires64.getCode());
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_shuffle_is_permutation);
+   RUN_TEST(test_same_seed_same_order);
+   RUN_TEST(test_shuffle_uniform);
+   RUN_TEST(test_new_game_new_seed);
+   RUN_TEST(test_replay_seed);
+   RUN_TEST(test_draws_per_wire);
+   RUN_TEST(test_bench_generation);
+   RUN_TEST(test_replay_sixty_four_wires);
+   return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_tempo/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the tempo curve of the ticking.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <tempo.hpp>
+
+I2CQueue i2c;
+DisplayManager displays(&i2c);
+Timer timer(displays.get(0));
+Buzzer buzzer;
+Tempo tempo(&timer, &buzzer);
+
+// Run the loops for the given simulated time, 1 ms per pass.
+void run(uint32_t ms) {
+   for ( uint32_t i=0; i < ms; i++ ) {
+      mock::advance(1);
+      timer.loop(mock::now);
+      tempo.loop(mock::now);
+      buzzer.loop(mock::now);
+   }
+}
+
+// Return the interval of the curve with a division, as reference for the walk of the tempo.
+uint16_t expected(const TempoCurve* curve, uint32_t left, uint8_t mistakes) {
+   uint32_t index = left / curve->step;
+   if ( index >= curve->length ) {
+      index = curve->length - 1;
+   }
+   uint16_t interval = TEMPO_INTERVALS[index] >> (mistakes < curve->mistakes ? mistakes : curve->mistakes);
+   return interval < curve->minimum ? curve->minimum : interval;
+}
+
+void setUp() {
+   mock::reset();
+   Wire.reset();
+   i2c.reset();
+   displays = DisplayManager(&i2c);
+   displays.setup();
+   timer = Timer(displays.get(0));
+   timer.setup();
+   timer.setHighResolution(false);
+   buzzer = Buzzer();
+   buzzer.setup();
+   tempo = Tempo(&timer, &buzzer);
+   tempo.setup();
+}
+
+void tearDown() {
+}
+
+void test_curve_is_monotonic() {
+   for ( uint8_t i=1; i < 32; i++ ) {
+      TEST_ASSERT_LESS_OR_EQUAL(TEMPO_INTERVALS[i], TEMPO_INTERVALS[i-1]);
+   }
+   TEST_ASSERT_EQUAL(150, TEMPO_INTERVALS[0]);
+   TEST_ASSERT_EQUAL(600, TEMPO_INTERVALS[31]); // The old default speed
+}
+
+void test_interval_follows_time_left() {
+   timer.enterCountdown(15);
+   buzzer.startTicking();
+   tempo.start(&TEMPO_GAME_1);
+   run(1);
+   TEST_ASSERT_EQUAL(600, tempo.getInterval());
+   TEST_ASSERT_EQUAL(600, buzzer.getTickInterval());
+
+   // The curve starts at 10:40 and the interval only decreases.
+   uint16_t last = 600;
+   for ( uint32_t s=1; s <= 15 * 60; s++ ) {
+      run(1000);
+      uint32_t left = timer.getMinutes() * 60 + timer.getSeconds();
+      TEST_ASSERT_EQUAL(expected(&TEMPO_GAME_1, left, 0), tempo.getInterval());
+      TEST_ASSERT_LESS_OR_EQUAL(last, tempo.getInterval());
+      last = tempo.getInterval();
+   }
+   TEST_ASSERT_TRUE(timer.isTimerZero());
+   TEST_ASSERT_EQUAL(150, tempo.getInterval());
+}
+
+void test_mistakes_halve_the_interval() {
+   timer.enterCountdown(5);
+   buzzer.startTicking();
+   tempo.start(&TEMPO_GAME_1);
+   run(1);
+   uint32_t left = timer.getMinutes() * 60 + timer.getSeconds();
+   TEST_ASSERT_EQUAL(expected(&TEMPO_GAME_1, left, 0), tempo.getInterval());
+
+   tempo.setMistakes(1);
+   run(1);
+   TEST_ASSERT_EQUAL(expected(&TEMPO_GAME_1, left, 0) / 2, tempo.getInterval());
+
+   // Game 1 doubles the speed once, game 2 twice.
+   tempo.setMistakes(3);
+   run(1);
+   TEST_ASSERT_EQUAL(expected(&TEMPO_GAME_1, left, 0) / 2, tempo.getInterval());
+
+   tempo.start(&TEMPO_GAME_2);
+   tempo.setMistakes(3);
+   run(1);
+   TEST_ASSERT_EQUAL(expected(&TEMPO_GAME_2, left, 3), tempo.getInterval());
+   TEST_ASSERT_EQUAL(TEMPO_INTERVALS[30] / 4, tempo.getInterval());
+
+   // Near zero the minimum is used.
+   run(5 * 60 * 1000);
+   TEST_ASSERT_EQUAL(75, tempo.getInterval());
+}
+
+void test_ticks_speed_up() {
+   timer.enterCountdown(6);
+   buzzer.startTicking();
+   tempo.start(&TEMPO_GAME_2);
+
+   // Count the ticks in the first and in the last 10 seconds of the game.
+   uint32_t ticks[2] = { 0, 0 };
+   uint16_t last = 0;
+   for ( uint32_t ms=0; ms < 6 * 60000; ms++ ) {
+      run(1);
+      if ( buzzer.getFrequency() != last && buzzer.getFrequency() != 0 ) {
+         if ( ms < 10000 ) {
+            ticks[0]++;
+         } else if ( ms >= 6 * 60000 - 10000 ) {
+            ticks[1]++;
+         }
+      }
+      last = buzzer.getFrequency();
+   }
+   TEST_ASSERT_UINT32_WITHIN(1, 10000 / 600, ticks[0]);
+   TEST_ASSERT_UINT32_WITHIN(1, 10000 / 150, ticks[1]);
+}
+
+void test_stop_keeps_the_interval() {
+   timer.enterCountdown(1);
+   buzzer.startTicking();
+   tempo.start(&TEMPO_GAME_1);
+   run(1000);
+   uint16_t interval = tempo.getInterval();
+   tempo.stop();
+   run(30000);
+   TEST_ASSERT_EQUAL(interval, buzzer.getTickInterval());
+}
+
+void test_bench_loop() {
+   timer.enterCountdown(99);
+   tempo.start(&TEMPO_GAME_1);
+   BenchResult r = bench("Tempo::loop", 1000000, 1, [](uint32_t) {
+      timer.loop(mock::now);
+      tempo.loop(mock::now);
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_curve_is_monotonic);
+   RUN_TEST(test_interval_follows_time_left);
+   RUN_TEST(test_mistakes_halve_the_interval);
+   RUN_TEST(test_ticks_speed_up);
+   RUN_TEST(test_stop_keeps_the_interval);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
@@ -0,0 +1,231 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_timer/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the Timer driver.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Added the drift test over a full game.
+ *               19-10-2026 (MS): Added the tests of the tenths in the last minute.
+ *               19-10-2026 (MS): Added the test of the countdown on a hung bus.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <timer.hpp>
+
+I2CQueue i2c;
+DisplayManager displays(&i2c);
+Timer timer(displays.get(0));
+
+// Run the timer loop for the given simulated time, 1 ms per pass.
+void run(uint32_t ms) {
+   for ( uint32_t i=0; i < ms; i++ ) {
+      mock::advance(1);
+      timer.loop(mock::now);
+      displays.loop(mock::now);
+      i2c.loop(mock::now);
+   }
+}
+
+void setUp() {
+   mock::reset();
+   Wire.reset();
+   i2c.reset();
+   displays = DisplayManager(&i2c);
+   displays.setup();
+   timer = Timer(displays.get(0));
+   timer.setup();
+   i2c.setup();
+}
+
+void tearDown() {
+}
+
+void test_minute_rollover() {
+   timer.enterCountdown(2);
+   TEST_ASSERT_EQUAL(2, timer.getMinutes());
+   TEST_ASSERT_EQUAL(0, timer.getSeconds());
+
+   run(1100);
+   TEST_ASSERT_EQUAL(1, timer.getMinutes());
+   TEST_ASSERT_EQUAL(59, timer.getSeconds());
+
+   // Display shows 01:59
+   TEST_ASSERT_EQUAL_HEX8(0x3F, Wire.ram[0][0]);
+   TEST_ASSERT_EQUAL_HEX8(0x06, Wire.ram[0][2]);
+   TEST_ASSERT_EQUAL_HEX8(0x6D, Wire.ram[0][6]);
+   TEST_ASSERT_EQUAL_HEX8(0x6F, Wire.ram[0][8]);
+}
+
+void test_countdown_reaches_zero() {
+   timer.enterCountdown(1);
+   run(30 * 1000);
+   TEST_ASSERT_FALSE(timer.isTimerZero());
+
+   run(31 * 1000);
+   TEST_ASSERT_TRUE(timer.isTimerZero());
+
+   run(5000); // Stays at 00:00
+   TEST_ASSERT_TRUE(timer.isTimerZero());
+   TEST_ASSERT_EQUAL_HEX8(0x3F, Wire.ram[0][6]);
+   TEST_ASSERT_EQUAL_HEX8(0x3F, Wire.ram[0][8]);
+}
+
+void test_catch_up_after_stall() {
+   timer.enterCountdown(1);
+   mock::advance(3500); // Loop stalled for 3.5 seconds
+   run(1);
+   TEST_ASSERT_EQUAL(0, timer.getMinutes());
+   TEST_ASSERT_EQUAL(57, timer.getSeconds());
+}
+
+void test_full_game_end_error() {
+   timer.enterCountdown(50);
+   uint64_t start = mock::now;
+
+   // Loop with a varying latency and a web page send that stalls the loop now and then.
+   uint32_t passes = 0;
+   while ( true ) {
+      mock::advance( (passes % 1000 == 999) ? 250 : 1 + (passes % 7) );
+      timer.loop(mock::now);
+      passes++;
+      if ( timer.isTimerZero() ) {
+         break;
+      }
+      displays.loop(mock::now);
+      i2c.loop(mock::now);
+   }
+
+   int32_t error = (int32_t) (mock::now - start) - 50 * 60 * 1000;
+   char message[96];
+   snprintf(message, sizeof(message), "End of game error over 50 minutes: %d ms (%u loop passes)", (int) error, passes);
+   TEST_MESSAGE(message);
+
+   TEST_ASSERT_EQUAL(error, timer.getEndError());
+   TEST_ASSERT_GREATER_OR_EQUAL(0, error);
+   TEST_ASSERT_LESS_THAN(250, error); // Never more than one loop stall late
+}
+
+void test_tenths_in_last_minute() {
+   timer.enterCountdown(1);
+   run(250); // 59.8 left, shown as " 59.8" without colon
+   TEST_ASSERT_EQUAL_HEX8(0x00, Wire.ram[0][0]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('5'), Wire.ram[0][2]);
+   TEST_ASSERT_EQUAL_HEX8(0x00, Wire.ram[0][4]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('9') | FONT_DP, Wire.ram[0][6]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('8'), Wire.ram[0][8]);
+
+   run(50 * 1000); // 9.8 left, the leading zero is blank
+   TEST_ASSERT_EQUAL_HEX8(0x00, Wire.ram[0][2]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('9') | FONT_DP, Wire.ram[0][6]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('8'), Wire.ram[0][8]);
+
+   run(10 * 1000); // Finished on 00:00
+   TEST_ASSERT_TRUE(timer.isTimerZero());
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('0'), Wire.ram[0][0]);
+   TEST_ASSERT_EQUAL_HEX8(FONT_B, Wire.ram[0][4]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('0'), Wire.ram[0][8]);
+}
+
+void test_tenths_catch_up_after_stall() {
+   timer.enterCountdown(1);
+   run(1000);
+   mock::advance(1234); // Stalled, the next pass shows 57.8 at once
+   timer.loop(mock::now);
+   displays.loop(mock::now);
+   i2c.loop(mock::now);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('7') | FONT_DP, Wire.ram[0][6]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('8'), Wire.ram[0][8]);
+}
+
+void test_tenths_bytes_in_last_minute() {
+   timer.setHighResolution(true);
+   timer.enterCountdown(1);
+   uint32_t bytes = Wire.bytes;
+   run(60 * 1000);
+   bytes = Wire.bytes - bytes;
+
+   // Refreshing all five positions 10 times per second takes 10 * 60 * 5 * 3 = 9000 bytes.
+   char message[64];
+   snprintf(message, sizeof(message), "Last minute I2C bytes: %u (full refresh 9000)", (unsigned) bytes);
+   TEST_MESSAGE(message);
+   TEST_ASSERT_LESS_THAN(4500, bytes);
+}
+
+void test_clock_runs_on_hung_bus() {
+   timer.enterCountdown(2);
+   run(1000);
+
+   // The cable is loose for 10 seconds: every transaction hangs the bus until the timeout.
+   Wire.failResult = 4;
+   Wire.failCount = 0xFFFFFFFF;
+   Wire.failUs = I2C_QUEUE_TIMEOUT;
+   uint64_t blockedMax = 0;
+   for ( uint32_t i=0; i < 10000; i++ ) {
+      mock::advance(1);
+      uint64_t start = mock::now * 1000 + mock::nowMicros;
+      timer.loop(mock::now);
+      displays.loop(mock::now);
+      i2c.loop(mock::now);
+      uint64_t blocked = mock::now * 1000 + mock::nowMicros - start;
+      if ( blocked > blockedMax ) {
+         blockedMax = blocked;
+      }
+   }
+   TEST_ASSERT_EQUAL(1, timer.getMinutes());
+   TEST_ASSERT_EQUAL(49, timer.getSeconds());
+   TEST_ASSERT_LESS_THAN(2 * I2C_QUEUE_TIMEOUT, blockedMax);
+   TEST_ASSERT_GREATER_THAN(0, i2c.getRecoveries());
+   TEST_ASSERT_LESS_OR_EQUAL(10000 / I2C_QUEUE_HOLDOFF + 1, i2c.getRecoveries());
+
+   // The cable is fixed, the display lost power and is initialized again.
+   Wire.failCount = 0;
+   memset(Wire.ram, 0, sizeof(Wire.ram));
+   memset(Wire.lastCommand, 0, sizeof(Wire.lastCommand));
+   run(I2C_QUEUE_HOLDOFF + 100);
+   TEST_ASSERT_EQUAL_HEX8(0xE0 | DISPLAY_BRIGHTNESS, Wire.lastCommand[0]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('1'), Wire.ram[0][2]);
+   TEST_ASSERT_EQUAL_HEX8(fontGlyph('4'), Wire.ram[0][6]);
+
+   char message[96];
+   snprintf(message, sizeof(message), "Hung bus: max loop pass %u us, %u recoveries in 10 s",
+            (unsigned) blockedMax, (unsigned) i2c.getRecoveries());
+   TEST_MESSAGE(message);
+}
+
+void test_bench_loop() {
+   timer.enterCountdown(99);
+   BenchResult r = bench("Timer::loop", 1000000, 1, [](uint32_t) {
+      timer.loop(mock::now);
+      displays.loop(mock::now);
+   });
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_minute_rollover);
+   RUN_TEST(test_countdown_reaches_zero);
+   RUN_TEST(test_catch_up_after_stall);
+   RUN_TEST(test_full_game_end_error);
+   RUN_TEST(test_tenths_in_last_minute);
+   RUN_TEST(test_tenths_catch_up_after_stall);
+   RUN_TEST(test_tenths_bytes_in_last_minute);
+   RUN_TEST(test_clock_runs_on_hung_bus);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
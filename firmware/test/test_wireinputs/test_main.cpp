@@ -0,0 +1,353 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_wireinputs/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the wire inputs and the Wires driver with more wires.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Resistor ladder on A0.
+ *               19-10-2026 (MS): A calibration with a cut wire is not accepted.
+ *               19-10-2026 (MS): The shift registers get time to settle.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <wires.hpp>
+
+// Simulated chain of 74HC165 shift registers on the pins of the shift register input.
+namespace chain {
+   uint64_t inputs = 0; // Level of the inputs, bit i is wire i+1, 1 is high (cut)
+   uint8_t bits[64]; // Bits in the order they are shifted out
+   uint8_t position = 0; // Bit on QH
+   uint32_t clocks = 0; // Total clock pulses
+
+   // PL low loads the inputs, QH shows D7 of the first register.
+   void load() {
+      for ( uint8_t c=0; c < 8; c++ ) {
+         for ( uint8_t b=0; b < 8; b++ ) {
+            chain::bits[c*8 + (7-b)] = (chain::inputs >> (c*8 + b)) & 0x01;
+         }
+      }
+      chain::position = 0;
+      mock::pinLevels[SHIFT_DATA] = chain::bits[0];
+   }
+
+   // A rising edge of CP shifts the next bit to QH.
+   void clock() {
+      chain::clocks++;
+      chain::position = (chain::position + 1) & 63;
+      mock::pinLevels[SHIFT_DATA] = chain::bits[chain::position];
+   }
+
+   void attach() {
+      chain::inputs = 0;
+      attachInterrupt(SHIFT_LOAD, chain::load, FALLING);
+      attachInterrupt(SHIFT_CLOCK, chain::clock, RISING);
+   }
+}
+
+Buzzer buzzer;
+Wires<16, WireShiftRegister<16>> wires16(&buzzer);
+Wires<64, WireShiftRegister<64>> wires64(&buzzer);
+Wires<5, WireLadder<5>> wiresLadder(&buzzer);
+
+// ADC value of the resistor ladder of five wires for the mask of the cut wires.
+uint16_t ladder(uint8_t cut, uint16_t full = 1023) {
+   return (uint32_t) full * 32 / (32 + cut);
+}
+
+void setUp() {
+   mock::reset();
+   chain::attach();
+   buzzer.setup();
+}
+
+void tearDown() {
+}
+
+// Run the loop of the driver for the given simulated time, 1 ms per pass.
+template <typename W>
+void run(W& wires, uint32_t ms) {
+   for ( uint32_t i=0; i < ms; i++ ) {
+      mock::advance(1);
+      wires.loop(mock::now);
+   }
+}
+
+// Decode the correct order (1-N) from the generated code, BITS bits per wire.
+template <uint8_t N, uint8_t BITS>
+void order(const char* code, uint8_t o[N]) {
+   uint8_t length = strlen(code);
+   for ( uint8_t i=0; i < N; i++ ) {
+      o[i] = 0;
+      for ( uint8_t b=0; b < BITS; b++ ) {
+         uint16_t bit = i * BITS + b;
+         uint8_t digit = bit / 4;
+         if ( digit < length ) {
+            char c = code[length - 1 - digit];
+            uint8_t nibble = (c <= '9' ? c - '0' : c - 'A' + 10);
+            o[i] |= ((nibble >> (bit % 4)) & 0x01) << b;
+         }
+      }
+   }
+}
+
+void test_vertical_counter() {
+   WireDebounce<uint8_t> d;
+   d.reset(0xFF);
+   for ( uint8_t i=0; i < 15; i++ ) {
+      TEST_ASSERT_EQUAL_HEX8(0xFF, d.update(0xF0));
+   }
+   TEST_ASSERT_EQUAL_HEX8(0xF0, d.update(0xF0)); // The 16th sample in a row
+
+   for ( uint8_t i=0; i < 100; i++ ) {
+      TEST_ASSERT_EQUAL_HEX8(0xF0, d.update(i % 8 == 0 ? 0xF0 : 0xFF)); // Interrupted, counts again
+   }
+}
+
+void test_shift_register_sample() {
+   wires16.setup();
+   TEST_ASSERT_EQUAL_UINT32(0xFFFF, wires16.sample());
+
+   chain::inputs = 0x8001 | 0x0100; // Wire 1, 9 and 16 are cut
+   TEST_ASSERT_EQUAL_UINT32(0x7EFE, wires16.sample());
+   TEST_ASSERT_FALSE(wires16.stateWire(1));
+   TEST_ASSERT_TRUE(wires16.stateWire(2));
+   TEST_ASSERT_FALSE(wires16.stateWire(9));
+   TEST_ASSERT_FALSE(wires16.stateWire(16));
+}
+
+void test_shift_register_one_pass() {
+   wires64.setup();
+   uint32_t clocks = chain::clocks;
+   uint32_t reads = mock::gpioReads;
+   chain::inputs = 0x8000000000000001ULL;
+   TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFE, (uint32_t) wires64.sample());
+   TEST_ASSERT_EQUAL_UINT32(0x7FFFFFFF, (uint32_t) (wires64.sample() >> 32));
+   TEST_ASSERT_EQUAL(2 * 64, chain::clocks - clocks); // One clock and one read per wire
+   TEST_ASSERT_EQUAL(2 * 64, mock::gpioReads - reads);
+}
+
+void test_shift_register_settles() {
+   wires16.setup();
+   uint32_t start = micros();
+   wires16.sample();
+   TEST_ASSERT_EQUAL((2 + 16) * SHIFT_SETTLE, micros() - start); // Both edges of PL and every clock
+}
+
+void test_code_five_wires_unchanged() {
+   // The code of five wires is 3 bits per wire without leading zeros, like before
+   Wires<> wires(&buzzer);
+   wires.setup();
+   uint8_t o[5];
+   order<5, 3>(wires.getCode(), o);
+   uint32_t c = 0;
+   for ( uint8_t i=0; i < 5; i++ ) {
+      c += o[i] << (i*3);
+   }
+   char expected[8];
+   snprintf(expected, sizeof(expected), "%X", c);
+   TEST_ASSERT_EQUAL_STRING(expected, wires.getCode());
+}
+
+void test_game_sixteen_wires() {
+   wires16.setup();
+   uint8_t o[16];
+   order<16, 5>(wires16.getCode(), o);
+   uint32_t seen = 0;
+   for ( uint8_t i=0; i < 16; i++ ) {
+      TEST_ASSERT_TRUE(o[i] >= 1 && o[i] <= 16);
+      seen |= 1UL << o[i];
+   }
+   TEST_ASSERT_EQUAL_UINT32(0x1FFFE, seen);
+
+   for ( uint8_t i=0; i < 16; i++ ) {
+      chain::inputs |= 1ULL << (o[i] - 1);
+      run(wires16, 500);
+      TEST_ASSERT_EQUAL(i+1, wires16.totalWiresCut());
+   }
+   TEST_ASSERT_TRUE(wires16.isWin());
+   TEST_ASSERT_FALSE(wires16.isLose());
+}
+
+void test_game_sixty_four_wires() {
+   wires64.setup();
+   uint8_t o[64];
+   order<64, 7>(wires64.getCode(), o);
+   uint64_t seen = 0;
+   for ( uint8_t i=0; i < 64; i++ ) {
+      TEST_ASSERT_TRUE(o[i] >= 1 && o[i] <= 64);
+      seen |= 1ULL << (o[i] - 1);
+   }
+   TEST_ASSERT_TRUE(seen == ~0ULL);
+
+   chain::inputs |= 1ULL << (o[1] - 1); // Wrong wire
+   run(wires64, 500);
+   TEST_ASSERT_EQUAL(1, wires64.getMistakes());
+   chain::inputs |= 1ULL << (o[63] - 1); // Wrong again
+   run(wires64, 500);
+   TEST_ASSERT_TRUE(wires64.isLose());
+}
+
+// The time per wire of a sample is the same for a short and a long chain.
+void test_bench_per_wire() {
+   wires16.setup();
+   wires64.setup();
+   BenchResult a = bench("WireShiftRegister<16>::sample", 200000, 0, [](uint32_t) {
+      volatile uint16_t mask = wires16.sample();
+      (void) mask;
+   });
+   BenchResult b = bench("WireShiftRegister<64>::sample", 200000, 0, [](uint32_t) {
+      volatile uint64_t mask = wires64.sample();
+      (void) mask;
+   });
+   char message[80];
+   snprintf(message, sizeof(message), "Per wire: 16 wires %.2f ns, 64 wires %.2f ns", a.nsPerCall / 16, b.nsPerCall / 64);
+   TEST_MESSAGE(message);
+   TEST_ASSERT_LESS_THAN(2.0 * a.nsPerCall / 16, b.nsPerCall / 64);
+}
+
+void test_bench_loop() {
+   wires64.setup();
+   BenchResult r = bench("Wires<64>::loop", 1000000, 1, [](uint32_t) {
+      wires64.loop(mock::now);
+   });
+   TEST_ASSERT_LESS_OR_EQUAL(1, r.maxBlockedMs); // A sample settles 66 us, it can pass the next ms of the clock
+}
+
+void test_ladder_decode() {
+   WireLadder<5> input;
+   for ( uint8_t cut=0; cut < 32; cut++ ) {
+      uint16_t band = input.getBand(cut);
+      TEST_ASSERT_GREATER_THAN(0, band);
+      TEST_ASSERT_EQUAL(cut, input.decode(ladder(cut)));
+      TEST_ASSERT_EQUAL(cut, input.decode(ladder(cut) + band));
+      TEST_ASSERT_EQUAL(cut, input.decode(ladder(cut) - band));
+      if ( cut < 31 ) { // Halfway to the next level is outside both bands
+         TEST_ASSERT_EQUAL(32, input.decode((ladder(cut) + ladder(cut + 1)) / 2));
+      }
+   }
+   TEST_ASSERT_EQUAL(32, input.decode(200)); // Below the lowest level, e.g. an open ladder
+}
+
+void test_ladder_calibration() {
+   WireLadder<5> input;
+   mock::adcValue = 1010; // The 3V3 and the divider of A0 give a lower full scale
+   input.begin(mock::now);
+   TEST_ASSERT_EQUAL(1010, input.getFull());
+   TEST_ASSERT_EQUAL(0x13, input.decode(ladder(0x13, 1010)));
+   TEST_ASSERT_EQUAL(0x1F, input.decode(ladder(0x1F, 1010)));
+
+   WireLadder<5> nominal;
+   TEST_ASSERT_EQUAL(32, nominal.decode(ladder(0x1F, 1010))); // Without calibration it is invalid
+
+   mock::adcValue = 700; // Not all wires connected, the last calibration is kept
+   TEST_ASSERT_FALSE(input.calibrate());
+   TEST_ASSERT_EQUAL(1010, input.getFull());
+}
+
+void test_ladder_calibration_with_a_cut_wire() {
+   for ( uint8_t cut=1; cut <= 4; cut++ ) { // 992, 963, 935 and 909 are above 900
+      WireLadder<5> input;
+      mock::adcValue = ladder(cut);
+      TEST_ASSERT_FALSE(input.calibrate());
+      TEST_ASSERT_EQUAL(LADDER_FULL, input.getFull());
+   }
+}
+
+void test_ladder_game() {
+   mock::adcValue = ladder(0);
+   wiresLadder.setup();
+   TEST_ASSERT_EQUAL_HEX8(0x1F, wiresLadder.getConnected());
+   uint8_t o[5];
+   order<5, 3>(wiresLadder.getCode(), o);
+
+   uint8_t cut = 0;
+   for ( uint8_t i=0; i < 5; i++ ) {
+      mock::adcValue = (ladder(cut) + ladder(cut | (1 << (o[i] - 1)))) / 2; // Between the levels while it is cut
+      run(wiresLadder, 100);
+      TEST_ASSERT_EQUAL(i, wiresLadder.totalWiresCut());
+
+      cut |= 1 << (o[i] - 1);
+      mock::adcValue = ladder(cut);
+      run(wiresLadder, 500);
+      TEST_ASSERT_EQUAL(i+1, wiresLadder.totalWiresCut());
+      TEST_ASSERT_EQUAL_HEX8(~cut & 0x1F, wiresLadder.getConnected());
+   }
+   TEST_ASSERT_TRUE(wiresLadder.isWin());
+   TEST_ASSERT_EQUAL(0, wiresLadder.getMistakes());
+   TEST_ASSERT_GREATER_THAN(0, wiresLadder.getInput()->getInvalid());
+}
+
+// The last levels of five wires are 8 LSB apart, with 2 LSB noise of the ADC every cut still debounces.
+void test_ladder_noise() {
+   WireLadder<5> input;
+   for ( uint8_t cut=0; cut < 32; cut++ ) {
+      TEST_ASSERT_GREATER_OR_EQUAL(3, input.getBand(cut));
+   }
+
+   mock::adcValue = ladder(0);
+   input.begin(mock::now);
+   const int8_t noise[] = { 2, -2, 1, -1, 0, 2, 2, -2, -2, -1, 1, 0, -2, 2, 1 };
+   uint32_t n = 0;
+   for ( uint8_t cut=0x1C; cut <= 0x1F; cut++ ) {
+      uint32_t invalid = 0;
+      for ( uint16_t t=0; t < 1000; t++ ) {
+         mock::adcValue = ladder(cut) + noise[n++ % sizeof(noise)];
+         mock::advance(LADDER_INTERVAL);
+         input.loop(mock::now);
+         if ( t == 100 ) {
+            invalid = input.getInvalid(); // The average has settled on the level
+         }
+         for ( uint8_t i=0; i < 3; i++ ) { // Every conversion alone is inside the band as well
+            TEST_ASSERT_EQUAL(cut, input.decode(ladder(cut) + noise[(n + i) % sizeof(noise)]));
+         }
+      }
+      TEST_ASSERT_EQUAL_HEX8(~cut & 0x1F, input.getConnected());
+      TEST_ASSERT_EQUAL_UINT32(invalid, input.getInvalid());
+   }
+}
+
+// All wires are read with one conversion per sample, on a lower rate than the polled pins.
+void test_ladder_one_conversion() {
+   mock::adcValue = ladder(0);
+   wiresLadder.setup();
+   uint32_t reads = mock::adcReads;
+   uint32_t gpio = mock::gpioReads;
+   run(wiresLadder, 1000);
+   TEST_ASSERT_EQUAL(1000 / LADDER_INTERVAL, mock::adcReads - reads);
+   TEST_ASSERT_EQUAL(0, mock::gpioReads - gpio);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_vertical_counter);
+   RUN_TEST(test_shift_register_sample);
+   RUN_TEST(test_shift_register_one_pass);
+   RUN_TEST(test_shift_register_settles);
+   RUN_TEST(test_code_five_wires_unchanged);
+   RUN_TEST(test_game_sixteen_wires);
+   RUN_TEST(test_game_sixty_four_wires);
+   RUN_TEST(test_bench_per_wire);
+   RUN_TEST(test_bench_loop);
+   RUN_TEST(test_ladder_decode);
+   RUN_TEST(test_ladder_calibration);
+   RUN_TEST(test_ladder_calibration_with_a_cut_wire);
+   RUN_TEST(test_ladder_game);
+   RUN_TEST(test_ladder_noise);
+   RUN_TEST(test_ladder_one_conversion);
+   return UNITY_END();
+}
@@ -0,0 +1,345 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : test/test_wires/test_main.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Native unit tests and benchmark for the Wires driver.
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): Sampling of all wires in one mask.
+ *               19-10-2026 (MS): Wire 1 is converted on a low rate.
+ *               19-10-2026 (MS): Wire 3-5 are confirmed on the time of their edges.
+ * @todo       :
+ */
+#include <unity.h>
+#include <bench.h>
+
+#include <wires.hpp>
+
+Buzzer buzzer;
+Wires<> wires(&buzzer);
+
+// Connect all the wires: wire 1 to 3V3 (A0), wire 2-5 to GND.
+void connectAll() {
+   mock::adcValue = 1024;
+   digitalWrite(D0, LOW);
+   digitalWrite(D5, LOW);
+   digitalWrite(D6, LOW);
+   digitalWrite(D7, LOW);
+}
+
+// Cut the given wire (1-5).
+void cut(uint8_t n) {
+   const uint8_t pins[] = { 0, A0, D0, D5, D6, D7 };
+   if ( n == 1 ) {
+      mock::adcValue = 0;
+   } else {
+      digitalWrite(pins[n], HIGH);
+   }
+}
+
+// Run the wires loop for the given simulated time, 1 ms per pass.
+void run(uint32_t ms) {
+   for ( uint32_t i=0; i < ms; i++ ) {
+      mock::advance(1);
+      wires.loop(mock::now);
+   }
+}
+
+// Decode the correct order (1-5) from the generated code.
+void order(uint8_t o[5]) {
+   uint32_t c = strtoul(wires.getCode(), NULL, 16);
+   for ( uint8_t i=0; i < 5; i++ ) {
+      o[i] = (c >> (i*3)) & 0x07;
+   }
+}
+
+void setUp() {
+   mock::reset();
+   connectAll();
+   buzzer.setup();
+   wires.setup();
+   run(100);
+}
+
+void tearDown() {
+}
+
+void test_order_is_permutation() {
+   uint8_t o[5];
+   order(o);
+   uint8_t seen = 0;
+   for ( uint8_t i=0; i < 5; i++ ) {
+      TEST_ASSERT_TRUE(o[i] >= 1 && o[i] <= 5);
+      seen |= 1 << o[i];
+   }
+   TEST_ASSERT_EQUAL_HEX8(0x3E, seen);
+}
+
+// Bounce the contact of a wire with an interrupt: pulses shorter than the stable time.
+void bounce(uint8_t pin) {
+   for ( uint8_t i=1; i <= 8; i++ ) {
+      digitalWrite(pin, HIGH);
+      run(i);
+      digitalWrite(pin, LOW);
+      run(WIRES_STABLE - 10);
+   }
+}
+
+void test_glitch_is_not_a_cut() {
+   // Wire 1 and 2 are sampled, a disconnection of 200 ms is filtered
+   cut(1);
+   cut(2);
+   run(200);
+   connectAll();
+   run(5000);
+   TEST_ASSERT_EQUAL(0, wires.totalWiresCut());
+
+   // Wire 3-5 are confirmed on their edges, bouncing shorter than the stable time is filtered
+   bounce(D5);
+   bounce(D6);
+   bounce(D7);
+   run(5000);
+   TEST_ASSERT_EQUAL(0, wires.totalWiresCut());
+   TEST_ASSERT_GREATER_THAN(40, wires.getInput()->getEdges());
+}
+
+void test_correct_order_wins() {
+   uint8_t o[5];
+   order(o);
+   for ( uint8_t i=0; i < 5; i++ ) {
+      cut(o[i]);
+      run(5000);
+      TEST_ASSERT_EQUAL(i+1, wires.totalWiresCut());
+      TEST_ASSERT_FALSE(wires.isLose());
+   }
+   TEST_ASSERT_TRUE(wires.isWin());
+}
+
+void test_one_mistake_still_wins() {
+   uint8_t o[5];
+   order(o);
+   const uint8_t sequence[] = { o[1], o[0], o[2], o[3], o[4] };
+   for ( uint8_t i=0; i < 5; i++ ) {
+      cut(sequence[i]);
+      run(5000);
+   }
+   TEST_ASSERT_FALSE(wires.isLose());
+   TEST_ASSERT_TRUE(wires.isWin());
+}
+
+void test_two_mistakes_lose() {
+   uint8_t o[5];
+   order(o);
+   cut(o[4]);
+   run(5000);
+   TEST_ASSERT_FALSE(wires.isLose());
+
+   cut(o[3]);
+   run(5000);
+   TEST_ASSERT_TRUE(wires.isLose());
+   TEST_ASSERT_FALSE(wires.isWin());
+}
+
+// The way the wires were read before: a digitalRead per wire through a switch.
+bool stateWireSwitch(uint8_t n) {
+   switch (n) {
+      case 1: return analogRead(A0) > 500;
+      case 2: return digitalRead(D0) == LOW;
+      case 3: return digitalRead(D5) == LOW;
+      case 4: return digitalRead(D6) == LOW;
+      case 5: return digitalRead(D7) == LOW;
+   }
+   return false;
+}
+
+void test_sample_mask() {
+   TEST_ASSERT_EQUAL_HEX8(WIRES_ALL, wires.sample());
+   for ( uint8_t n=1; n <= 5; n++ ) {
+      connectAll();
+      cut(n);
+      run(ANALOG_INTERVAL * ANALOG_AVERAGE); // The average of the ADC follows
+      TEST_ASSERT_EQUAL_HEX8(WIRES_ALL & ~(1 << (n-1)), wires.sample());
+      for ( uint8_t m=1; m <= 5; m++ ) {
+         TEST_ASSERT_EQUAL(stateWireSwitch(m), wires.stateWire(m));
+      }
+   }
+}
+
+void test_sample_reads_registers_once() {
+   uint32_t gpio = mock::gpioReads;
+   uint32_t adc = mock::adcReads;
+   wires.sample();
+   TEST_ASSERT_EQUAL(2, mock::gpioReads - gpio); // GPI and GP16I
+   TEST_ASSERT_EQUAL(0, mock::adcReads - adc); // The level of the ADC is cached
+
+   gpio = mock::gpioReads;
+   for ( uint8_t n=1; n <= 5; n++ ) {
+      stateWireSwitch(n);
+   }
+   TEST_ASSERT_EQUAL(4, mock::gpioReads - gpio);
+}
+
+void test_cut_detected_after_debounce() {
+   uint8_t o[5];
+   order(o);
+   cut(2); // Wire 2 is sampled, wire 1 is also averaged and wire 3-5 have an interrupt
+   run(WIRES_SAMPLE_TIME * 14);
+   TEST_ASSERT_EQUAL(0, wires.totalWiresCut());
+   run(WIRES_SAMPLE_TIME * 4);
+   TEST_ASSERT_EQUAL(1, wires.totalWiresCut());
+   TEST_ASSERT_EQUAL(4, __builtin_popcount(wires.getConnected()));
+}
+
+void test_two_cuts_at_once() {
+   uint8_t o[5];
+   order(o);
+   cut(o[0]);
+   cut(o[1]);
+   run(1000);
+   TEST_ASSERT_EQUAL(2, wires.totalWiresCut());
+   TEST_ASSERT_FALSE(wires.isLose()); // One of the two is handled first, at most one mistake
+}
+
+void test_adc_rate_limited() {
+   uint32_t adc = mock::adcReads;
+   run(10000);
+   TEST_ASSERT_EQUAL(10000 / ANALOG_INTERVAL, mock::adcReads - adc); // It was one per sample of 21 ms
+
+   // The rate of before, for the throughput measurement of /throughput.
+   wires.getInput()->getAnalog()->setInterval(20);
+   run(ANALOG_INTERVAL); // The next conversion is still on the old interval
+   adc = mock::adcReads;
+   run(10000);
+   TEST_ASSERT_UINT32_WITHIN(1, 10000 / 20, mock::adcReads - adc);
+   wires.getInput()->getAnalog()->setInterval(ANALOG_INTERVAL);
+}
+
+void test_adc_hysteresis() {
+   AnalogInput* analog = wires.getInput()->getAnalog();
+   TEST_ASSERT_TRUE(analog->isHigh());
+
+   mock::adcValue = 500; // Between the thresholds, the level is kept
+   run(2000);
+   TEST_ASSERT_TRUE(analog->isHigh());
+   mock::adcValue = ANALOG_LOW - 1;
+   run(ANALOG_INTERVAL * ANALOG_AVERAGE);
+   TEST_ASSERT_FALSE(analog->isHigh());
+   mock::adcValue = 500;
+   run(2000);
+   TEST_ASSERT_FALSE(analog->isHigh());
+   mock::adcValue = 1024;
+   run(ANALOG_INTERVAL * ANALOG_AVERAGE);
+   TEST_ASSERT_TRUE(analog->isHigh());
+}
+
+void test_adc_noise_is_averaged() {
+   AnalogInput* analog = wires.getInput()->getAnalog();
+   for ( uint32_t i=0; i < 100; i++ ) {
+      mock::adcValue = (i % 4 == 0 ? 0 : 1024); // One conversion of four is disturbed
+      run(ANALOG_INTERVAL);
+      TEST_ASSERT_TRUE(analog->isHigh());
+   }
+   TEST_ASSERT_EQUAL(0, wires.totalWiresCut());
+}
+
+void test_cut_latency_with_interrupt() {
+   for ( uint8_t n=3; n <= 5; n++ ) {
+      cut(n);
+      run(WIRES_STABLE - 1);
+      TEST_ASSERT_EQUAL(n-3, wires.totalWiresCut());
+      run(1);
+      TEST_ASSERT_EQUAL(n-2, wires.totalWiresCut()); // Feedback at once after the stable time
+      TEST_ASSERT_EQUAL(WIRES_STABLE, wires.getLatencyLast());
+   }
+   TEST_ASSERT_EQUAL(WIRES_STABLE, wires.getLatencyMax());
+}
+
+void test_cut_with_bouncing_contact() {
+   digitalWrite(D6, HIGH); // The cutter bounces on the wire before it is cut
+   run(3);
+   digitalWrite(D6, LOW);
+   run(2);
+   digitalWrite(D6, HIGH);
+   run(WIRES_STABLE + 1);
+   TEST_ASSERT_EQUAL(1, wires.totalWiresCut());
+   TEST_ASSERT_LESS_OR_EQUAL(WIRES_STABLE + 1, wires.getLatencyLast());
+}
+
+void test_cut_during_slow_loop() {
+   cut(4);
+   mock::advance(100);
+   connectAll(); // Connected again before the loop ran
+   mock::advance(300);
+   wires.loop(mock::now);
+   TEST_ASSERT_EQUAL(1, wires.totalWiresCut()); // The cut is confirmed on the times of the edges
+   TEST_ASSERT_EQUAL(400, wires.getLatencyLast()); // The loop was late, the counter shows it
+}
+
+void test_lost_edges_resync() {
+   for ( uint8_t i=0; i < 2 * WIRES_EDGES; i++ ) {
+      digitalWrite(D7, i % 2 ? LOW : HIGH);
+   }
+   digitalWrite(D7, HIGH);
+   run(WIRES_STABLE * 2);
+   TEST_ASSERT_EQUAL(1, wires.totalWiresCut());
+}
+
+// Natively the registers are simulated, so the time per call is not the time on the board. The register reads
+// above are the difference, the cycles on the board are shown on /stats as wires.sampleCycles.
+void test_bench_sample() {
+   bench("Wires: digitalRead per wire", 1000000, 0, [](uint32_t) {
+      volatile uint8_t mask = 0;
+      for ( uint8_t n=1; n <= 5; n++ ) {
+         mask |= stateWireSwitch(n) << (n-1);
+      }
+   });
+   BenchResult b = bench("Wires::sample", 1000000, 0, [](uint32_t) {
+      volatile uint8_t mask = wires.sample();
+      (void) mask;
+   });
+   TEST_ASSERT_EQUAL(0, b.maxBlockedMs);
+   TEST_ASSERT_LESS_THAN(1000.0, b.nsPerCall);
+}
+
+void test_bench_loop() {
+   BenchResult r = bench("Wires::loop", 1000000, 1, [](uint32_t) {
+      wires.loop(mock::now);
+   });
+   TEST_ASSERT_EQUAL(0, r.maxBlockedMs);
+   TEST_ASSERT_LESS_THAN(1000.0, r.nsPerCall);
+}
+
+int main(int, char **) {
+   UNITY_BEGIN();
+   RUN_TEST(test_order_is_permutation);
+   RUN_TEST(test_glitch_is_not_a_cut);
+   RUN_TEST(test_correct_order_wins);
+   RUN_TEST(test_one_mistake_still_wins);
+   RUN_TEST(test_two_mistakes_lose);
+   RUN_TEST(test_sample_mask);
+   RUN_TEST(test_sample_reads_registers_once);
+   RUN_TEST(test_cut_detected_after_debounce);
+   RUN_TEST(test_two_cuts_at_once);
+   RUN_TEST(test_cut_latency_with_interrupt);
+   RUN_TEST(test_cut_with_bouncing_contact);
+   RUN_TEST(test_cut_during_slow_loop);
+   RUN_TEST(test_lost_edges_resync);
+   RUN_TEST(test_adc_rate_limited);
+   RUN_TEST(test_adc_hysteresis);
+   RUN_TEST(test_adc_noise_is_averaged);
+   RUN_TEST(test_bench_sample);
+   RUN_TEST(test_bench_loop);
+   return UNITY_END();
+}
@@ -0,0 +1,542 @@
+/**
+ * This file is part of HackTheBom.
+ * HackTheBom is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * HackTheBom is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License along with
+ * HackTheBom. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file       : tools/melody2h/melody2h.cpp
+ * @author     : Maurice Snoeren (MS)
+ * @description: Host tool that converts a monophonic track of a MIDI file (.mid) or a MusicXML
+ *               file (.musicxml/.xml) into the packed melody format of include/melody.hpp. It
+ *               writes a header with the melody for include/melodies.hpp and reports the size
+ *               that is saved compared to a table of 32 bits per note.
+ *               Usage: melody2h [options] <input> [-o <output.h>]
+ *                 --name <NAME>   name of the melody, default the file name
+ *                 --track <n>     MIDI track, default the first track with notes
+ *                 --channel <n>   MIDI channel 1-16, default all channels
+ *                 --part <n>      MusicXML part, default 1
+ *                 --tempo <bpm>   tempo in quarter notes per minute, default from the file
+ *                 --repeat <n>    total times the melody is played, 0 is forever (default)
+ * @date       : 19-10-2026
+ * @version    : 1.0
+ * @updates    : 19-10-2026 (MS): Initial code.
+ *               19-10-2026 (MS): A truncated MIDI track and a number that is not a number stop with an error.
+ * @todo       :
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Packed melody format, the same values as include/melody.hpp.
+#define NOTE_REST     0
+#define NOTE_OCTAVE   15
+#define MELODY_DOTTED 0x80
+#define MELODY_OCTAVE 4
+
+// Shortest duration in the packed format is a 1/32 note, all durations are counted in 1/32 notes.
+#define UNITS_WHOLE 32
+
+/* Struct: Event
+ * A note or rest of the monophonic line, in ticks of the input file.
+ */
+struct Event {
+   int note; // MIDI note number, -1 is a rest
+   uint32_t start; // Start in ticks
+   uint32_t end; // End in ticks
+};
+
+/* Struct: Line
+ * The monophonic line that is read from the input file.
+ */
+struct Line {
+   std::vector<Event> events;
+   uint32_t ticksPerQuarter = 480;
+   uint32_t tempo = 0; // Quarter notes per minute, 0 when the file has no tempo
+   uint32_t cut = 0; // Total notes that were cut by a next note (polyphonic input)
+};
+
+/* Print an error and stop the tool.
+ *
+ * @param message: the error
+ * @return None
+ */
+[[noreturn]] static void fail(const std::string& message) {
+   fprintf(stderr, "melody2h: %s\n", message.c_str());
+   exit(1);
+}
+
+/* Read a variable length quantity of a MIDI file.
+ *
+ * @param data: the file
+ * @param pos: position, it is moved after the value
+ * @param end: end of the track
+ * @return The value.
+ */
+static uint32_t readVarLen(const std::vector<uint8_t>& data, size_t& pos, size_t end) {
+   uint32_t value = 0;
+   for ( int i=0; i < 4 && pos < end; i++ ) {
+      uint8_t b = data[pos++];
+      value = (value << 7) | (b & 0x7F);
+      if ( !(b & 0x80) ) {
+         return value;
+      }
+   }
+   return value;
+}
+
+/* Read the next byte of a MIDI track.
+ *
+ * @param data: the file
+ * @param pos: position, it is moved after the byte
+ * @param end: end of the track
+ * @return The byte, the tool stops when the track ends before it.
+ */
+static uint8_t readByte(const std::vector<uint8_t>& data, size_t& pos, size_t end) {
+   if ( pos >= end ) {
+      fail("MIDI track ends in the middle of an event");
+   }
+   return data[pos++];
+}
+
+/* Read a big endian number of a MIDI file.
+ *
+ * @param data: the file
+ * @param pos: position of the number
+ * @param bytes: total bytes
+ * @return The value.
+ */
+static uint32_t readBig(const std::vector<uint8_t>& data, size_t pos, int bytes) {
+   uint32_t value = 0;
+   for ( int i=0; i < bytes; i++ ) {
+      value = (value << 8) | data.at(pos + i);
+   }
+   return value;
+}
+
+/* Struct: MidiNote
+ * A note on or note off of a MIDI track.
+ */
+struct MidiNote {
+   uint32_t tick;
+   bool on;
+   int note;
+   int channel;
+};
+
+/* Read the monophonic line of a standard MIDI file. When notes overlap, the next note cuts the note
+ * that is playing.
+ *
+ * @param data: the file
+ * @param track: the track, -1 for the first track with notes
+ * @param channel: the channel 0-15, -1 for all channels
+ * @return The line.
+ */
+static Line readMidi(const std::vector<uint8_t>& data, int track, int channel) {
+   Line line;
+   if ( data.size() < 14 || std::string(data.begin(), data.begin() + 4) != "MThd" ) {
+      fail("not a MIDI file");
+   }
+   uint32_t tracks = readBig(data, 10, 2);
+   uint32_t division = readBig(data, 12, 2);
+   if ( division & 0x8000 ) {
+      fail("SMPTE time division is not supported");
+   }
+   line.ticksPerQuarter = division;
+
+   std::vector<std::vector<MidiNote>> notes(tracks);
+   std::vector<uint32_t> ends(tracks, 0);
+   size_t pos = 8 + readBig(data, 4, 4);
+   for ( uint32_t t=0; t < tracks && pos + 8 <= data.size(); t++ ) {
+      if ( std::string(data.begin() + pos, data.begin() + pos + 4) != "MTrk" ) {
+         fail("track " + std::to_string(t) + " is missing");
+      }
+      size_t end = std::min(data.size(), pos + 8 + readBig(data, pos + 4, 4));
+      pos += 8;
+
+      uint32_t tick = 0;
+      uint8_t status = 0;
+      while ( pos < end ) {
+         tick += readVarLen(data, pos, end);
+         if ( readByte(data, pos, end) & 0x80 ) {
+            status = data[pos - 1];
+         } else {
+            pos--; // Running status, the byte is the first data byte
+         }
+         if ( status == 0xFF ) { // Meta event
+            uint8_t type = readByte(data, pos, end);
+            uint32_t length = readVarLen(data, pos, end);
+            if ( type == 0x51 && length == 3 && pos + 3 <= end && line.tempo == 0 ) {
+               line.tempo = (uint32_t) (60000000.0 / readBig(data, pos, 3) + 0.5);
+            }
+            pos += length;
+            status = 0; // Meta and sysex events cancel the running status
+         } else if ( status == 0xF0 || status == 0xF7 ) {
+            pos += readVarLen(data, pos, end);
+            status = 0;
+         } else {
+            uint8_t type = status & 0xF0;
+            uint8_t ch = status & 0x0F;
+            uint8_t a = readByte(data, pos, end);
+            uint8_t b = (type == 0xC0 || type == 0xD0) ? 0 : readByte(data, pos, end);
+            if ( (type == 0x90 || type == 0x80) && (channel < 0 || channel == ch) ) {
+               notes[t].push_back( { tick, type == 0x90 && b > 0, a, ch } );
+            }
+         }
+      }
+      ends[t] = tick; // End of track, a rest after the last note is kept
+      pos = end;
+   }
+
+   if ( track < 0 ) {
+      for ( uint32_t t=0; t < tracks && track < 0; t++ ) {
+         if ( !notes[t].empty() ) {
+            track = t;
+         }
+      }
+   }
+   if ( track < 0 || track >= (int) tracks || notes[track].empty() ) {
+      fail("no notes found in the selected track");
+   }
+
+   // Note offs before note ons on the same tick, so a next note does not cut itself.
+   std::vector<MidiNote>& list = notes[track];
+   std::stable_sort(list.begin(), list.end(), [](const MidiNote& x, const MidiNote& y) {
+      return x.tick < y.tick || (x.tick == y.tick && !x.on && y.on);
+   });
+
+   int playing = -1;
+   uint32_t start = 0;
+   uint32_t last = 0;
+   for ( const MidiNote& n : list ) {
+      if ( n.on ) {
+         if ( playing >= 0 ) {
+            line.events.push_back( { playing, start, n.tick } );
+            line.cut++;
+         } else if ( n.tick > last ) {
+            line.events.push_back( { -1, last, n.tick } );
+         }
+         playing = n.note;
+         start = n.tick;
+      } else if ( n.note == playing ) {
+         line.events.push_back( { playing, start, n.tick } );
+         playing = -1;
+         last = n.tick;
+      }
+   }
+   if ( playing >= 0 ) {
+      fail("note " + std::to_string(playing) + " is never released");
+   }
+   if ( ends[track] > last ) {
+      line.events.push_back( { -1, last, ends[track] } );
+   }
+
+   return line;
+}
+
+/* Return the text of the first element with the given tag in the text.
+ *
+ * @param text: XML text
+ * @param tag: the tag without brackets
+ * @return The text of the element, empty when it is not found.
+ */
+static std::string xmlValue(const std::string& text, const std::string& tag) {
+   size_t begin = text.find("<" + tag + ">");
+   if ( begin == std::string::npos ) {
+      return "";
+   }
+   begin += tag.size() + 2;
+   size_t end = text.find("</" + tag + ">", begin);
+   return end == std::string::npos ? "" : text.substr(begin, end - begin);
+}
+
+/* Return the number of the first element with the given tag in the text.
+ *
+ * @param text: XML text
+ * @param tag: the tag without brackets
+ * @return The number, the tool stops when it is missing or not a number.
+ */
+static long xmlNumber(const std::string& text, const std::string& tag) {
+   std::string value = xmlValue(text, tag);
+   try {
+      return std::stol(value);
+   } catch ( const std::exception& ) {
+      fail("<" + tag + "> is not a number: \"" + value + "\"");
+   }
+}
+
+/* Read the monophonic line of the first voice of a part of a MusicXML file. Chords are reduced to their
+ * first note and tied notes are joined.
+ *
+ * @param text: the file
+ * @param part: the part, starting at 1
+ * @return The line.
+ */
+static Line readMusicXml(const std::string& text, int part) {
+   Line line;
+   size_t pos = 0;
+   for ( int p=0; p < part; p++ ) {
+      pos = text.find("<part ", pos);
+      if ( pos == std::string::npos ) {
+         fail("part " + std::to_string(part) + " is not found");
+      }
+      pos++;
+   }
+   size_t partEnd = text.find("</part>", pos);
+
+   // The ticks are in divisions of a quarter note, they can change per measure.
+   uint32_t tick = 0;
+   double scale = 1.0;
+   line.ticksPerQuarter = 0;
+   bool tied = false;
+   while ( pos < partEnd ) {
+      size_t note = text.find("<note", pos);
+      size_t divisions = text.find("<divisions>", pos);
+      size_t sound = text.find("<sound ", pos);
+      size_t next = std::min( { note, divisions, sound, partEnd } );
+      if ( next == partEnd ) {
+         break;
+      }
+
+      if ( next == divisions ) {
+         long d = xmlNumber(text.substr(next), "divisions");
+         if ( d <= 0 ) {
+            fail("<divisions> must be positive");
+         }
+         if ( line.ticksPerQuarter == 0 ) {
+            line.ticksPerQuarter = d;
+         }
+         scale = (double) line.ticksPerQuarter / d;
+         pos = next + 1;
+
+      } else if ( next == sound ) {
+         size_t end = text.find(">", next);
+         std::string element = text.substr(next, end - next);
+         size_t t = element.find("tempo=\"");
+         if ( t != std::string::npos && line.tempo == 0 ) {
+            try {
+               line.tempo = (uint32_t) (std::stod(element.substr(t + 7)) + 0.5);
+            } catch ( const std::exception& ) {
+               fail("tempo of <sound> is not a number");
+            }
+         }
+         pos = end;
+
+      } else {
+         size_t end = text.find("</note>", next);
+         std::string element = text.substr(next, end - next);
+         pos = end;
+
+         std::string voice = xmlValue(element, "voice");
+         if ( element.find("<chord") != std::string::npos || element.find("<grace") != std::string::npos ||
+              (!voice.empty() && voice != "1") ) {
+            continue;
+         }
+
+         long length = xmlNumber(element, "duration");
+         if ( length < 0 ) {
+            fail("<duration> is negative");
+         }
+         uint32_t duration = (uint32_t) (length * scale + 0.5);
+         int midi = -1;
+         if ( element.find("<rest") == std::string::npos ) {
+            static const int steps[7] = { 9, 11, 0, 2, 4, 5, 7 }; // A B C D E F G
+            std::string step = xmlValue(element, "step");
+            if ( step.size() != 1 || step[0] < 'A' || step[0] > 'G' ) {
+               fail("<step> is not A-G: \"" + step + "\"");
+            }
+            int octave = (int) xmlNumber(element, "octave");
+            int alter = (xmlValue(element, "alter").empty() ? 0 : (int) xmlNumber(element, "alter"));
+            midi = (octave + 1) * 12 + steps[step[0] - 'A'] + alter;
+         }
+
+         if ( tied && !line.events.empty() && line.events.back().note == midi ) {
+            line.events.back().end += duration;
+         } else {
+            line.events.push_back( { midi, tick, tick + duration } );
+         }
+         tied = element.find("<tie type=\"start\"") != std::string::npos;
+         tick += duration;
+      }
+   }
+
+   if ( line.ticksPerQuarter == 0 || line.events.empty() ) {
+      fail("no notes found in the selected part");
+   }
+   return line;
+}
+
+/* Return the packed duration of a length in 1/32 notes, or 0xFF when it cannot be packed.
+ *
+ * @param units: length in 1/32 notes
+ * @return Bit 4-6 and the dotted bit of the note byte.
+ */
+static uint8_t packDuration(uint32_t units) {
+   for ( uint8_t d=0; d <= 5; d++ ) {
+      uint32_t length = UNITS_WHOLE >> d;
+      if ( units == length ) {
+         return d << 4;
+      }
+      if ( length >= 2 && units == length + length / 2 ) {
+         return (d << 4) | MELODY_DOTTED;
+      }
+   }
+   return 0xFF;
+}
+
+/* Split a length in 1/32 notes in the longest durations that can be packed.
+ *
+ * @param units: length in 1/32 notes
+ * @return The packed durations.
+ */
+static std::vector<uint8_t> splitDuration(uint32_t units) {
+   static const uint32_t lengths[] = { 48, 32, 24, 16, 12, 8, 6, 4, 3, 2, 1 };
+   std::vector<uint8_t> parts;
+   while ( units > 0 ) {
+      for ( uint32_t length : lengths ) {
+         if ( length <= units ) {
+            parts.push_back(packDuration(length));
+            units -= length;
+            break;
+         }
+      }
+   }
+   return parts;
+}
+
+int main(int argc, char** argv) {
+   std::string input;
+   std::string output;
+   std::string name;
+   int track = -1;
+   int channel = -1;
+   int part = 1;
+   int tempo = 0;
+   int repeat = 0;
+
+   for ( int i=1; i < argc; i++ ) {
+      std::string arg = argv[i];
+      bool value = (i + 1 < argc);
+      if ( arg == "-o" && value ) output = argv[++i];
+      else if ( arg == "--name" && value ) name = argv[++i];
+      else if ( arg == "--track" && value ) track = atoi(argv[++i]);
+      else if ( arg == "--channel" && value ) channel = atoi(argv[++i]) - 1;
+      else if ( arg == "--part" && value ) part = atoi(argv[++i]);
+      else if ( arg == "--tempo" && value ) tempo = atoi(argv[++i]);
+      else if ( arg == "--repeat" && value ) repeat = atoi(argv[++i]);
+      else if ( arg[0] != '-' && input.empty() ) input = arg;
+      else fail("usage: melody2h [--name NAME] [--track n] [--channel n] [--part n] [--tempo bpm] [--repeat n] "
+                "<input.mid|input.musicxml> [-o output.h]");
+   }
+   if ( input.empty() ) {
+      fail("no input file");
+   }
+
+   std::ifstream file(input, std::ios::binary);
+   if ( !file ) {
+      fail("cannot open " + input);
+   }
+   std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+   std::string extension = input.substr(input.find_last_of('.') + 1);
+   std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+   Line line = (extension == "mid" || extension == "midi") ? readMidi(data, track, channel)
+                                                           : readMusicXml(std::string(data.begin(), data.end()), part);
+
+   if ( name.empty() ) {
+      size_t slash = input.find_last_of("/\\");
+      name = input.substr(slash == std::string::npos ? 0 : slash + 1);
+      name = name.substr(0, name.find('.'));
+   }
+   for ( char& c : name ) {
+      c = isalnum((unsigned char) c) ? toupper((unsigned char) c) : '_';
+   }
+   if ( tempo == 0 ) {
+      tempo = line.tempo > 0 ? line.tempo : 120;
+   }
+
+   // Quantize the start and end of every event on 1/32 notes, so rounding errors do not add up.
+   std::vector<uint8_t> packed;
+   uint32_t notes = 0;
+   uint32_t split = 0;
+   uint32_t dropped = 0;
+   int octave = MELODY_OCTAVE;
+   double units = (double) UNITS_WHOLE / (4 * line.ticksPerQuarter);
+   for ( const Event& e : line.events ) {
+      uint32_t start = (uint32_t) (e.start * units + 0.5);
+      uint32_t end = (uint32_t) (e.end * units + 0.5);
+      if ( end <= start ) {
+         dropped += (e.note >= 0);
+         continue;
+      }
+
+      uint8_t pitch = NOTE_REST;
+      if ( e.note >= 0 ) {
+         int o = std::min(7, std::max(0, e.note / 12 - 1));
+         pitch = e.note % 12 + 1;
+         if ( o != octave ) {
+            packed.push_back((uint8_t) ((o << 4) | NOTE_OCTAVE));
+            octave = o;
+         }
+      }
+
+      std::vector<uint8_t> parts = splitDuration(end - start);
+      if ( e.note >= 0 ) {
+         notes += parts.size();
+         split += (parts.size() > 1);
+      }
+      for ( uint8_t p : parts ) {
+         packed.push_back(p | pitch);
+      }
+   }
+
+   // Header for include/melodies.hpp.
+   std::ostringstream header;
+   header << "// Generated by melody2h from " << input.substr(input.find_last_of("/\\") + 1) << ", do not edit.\n";
+   header << "#pragma once\n#include <Arduino.h>\n\n#include <melody.hpp>\n\n";
+   header << "const uint8_t " << name << "_NOTES[] PROGMEM = {";
+   for ( size_t i=0; i < packed.size(); i++ ) {
+      char hex[8];
+      snprintf(hex, sizeof(hex), "0x%02X", packed[i]);
+      header << (i % 12 == 0 ? "\n   " : " ") << hex << ",";
+   }
+   header << "\n};\n";
+   header << "const Melody MELODY_" << name << " = { " << name << "_NOTES, sizeof(" << name << "_NOTES), "
+          << tempo << ", " << repeat << " };\n";
+
+   if ( output.empty() ) {
+      fputs(header.str().c_str(), stdout);
+   } else {
+      std::ofstream out(output);
+      out << header.str();
+      if ( !out ) {
+         fail("cannot write " + output);
+      }
+   }
+
+   // Size report: a table of uint32_t frequencies or Tone steps takes 4 bytes per note.
+   // The packed melody can be larger for a few long notes, so the saving is signed.
+   uint32_t table = notes * 4;
+   int saved = (int) table - (int) packed.size();
+   fprintf(stderr, "%s: %u notes, %u bytes packed, %u bytes as 32 bits per note, saved %d bytes (%d%%), tempo %d bpm\n",
+           name.c_str(), notes, (unsigned) packed.size(), table, saved, table > 0 ? 100 * saved / (int) table : 0, tempo);
+   if ( line.cut > 0 || split > 0 || dropped > 0 ) {
+      fprintf(stderr, "%s: %u overlapping notes cut, %u notes split in tied parts, %u notes shorter than 1/32 dropped\n",
+              name.c_str(), line.cut, split, dropped);
+   }
+
+   return 0;
+}